@@ -1,19 +1,27 @@
+#include <algorithm>
+
 #include <QChar>
-#include <QDebug>
+#include <QResizeEvent>
+#include <QtMath>
 #include <QKeyEvent>
 #include <QList>
 #include <QMargins>
 #include <QMouseEvent>
+#include <QPalette>
 #include <QPoint>
 #include <QSize>
 #include <QSizePolicy>
 #include <QString>
+#include <QTextCharFormat>
 #include <QTextCursor>
 #include <QTextDocument>
 #include <QTextEdit>
 #include <QWidget>
 
 #include "AutoSizeTextEdit.h"
+#include "HeightEstimator.h"
+#include "Logging.h"
+#include "Utility.h"
 
 AutoSizeTextEdit::AutoSizeTextEdit(QWidget* parent)
     : QTextEdit(parent)
@@ -56,51 +64,23 @@ AutoSizeTextEdit::AutoSizeTextEdit(QWidget* parent)
 
 AutoSizeTextEdit::~AutoSizeTextEdit()
 {
-    qDebug() << __FUNCTION__;
+    qCDebug(lcLifetime) << __FUNCTION__;
 }
 
 void AutoSizeTextEdit::simplify()
 {
     auto current = toPlainText();
-    auto simplified = current.simplified();
-    if (current == simplified) return;
+    if (Utility::isSimplified(current)) return;
+    auto simplified = Utility::simplified(current);
 
     auto cursor = textCursor();
     auto initial_cursor_pos = cursor.position();
+    auto markers = splitMarkers();
 
     // Build position mapping between original and normalized text
-    QList<int> map(current.length());
-    auto simplified_pos = 0;
-
-    // Skip leading whitespace in original
-    auto leading_spaces = 0;
-
-    while (leading_spaces < current.length() && current[leading_spaces].isSpace())
-        leading_spaces++;
-
-    auto last_c_was_space = false;
-
-    for (auto i = 0; i < current.length(); i++)
-    {
-        map[i] = simplified_pos;
-        if (i < leading_spaces) continue;
-
-        if (current[i].isSpace())
-        {
-            if (!last_c_was_space)
-            {
-                simplified_pos++;
-                last_c_was_space = true;
-            }
-        }
-        else
-        {
-            simplified_pos++;
-            last_c_was_space = false;
-        }
-    }
+    auto map = Utility::simplifiedPositions(current);
 
-    setPlainText(simplified);
+    loadPlainText(simplified);
 
     // Adjust cursor position (if it was at the end, map length may be
     // exceeded)
@@ -111,6 +91,143 @@ void AutoSizeTextEdit::simplify()
     new_pos = qBound(0, new_pos, simplified.length());
     cursor.setPosition(new_pos);
     setTextCursor(cursor);
+
+    // Setting the text reset the markers' cursors, so map them over too
+    if (markers.isEmpty()) return;
+
+    for (auto& marker : markers)
+        marker = map[marker];
+
+    setSplitMarkers_(markers);
+}
+
+QList<int> AutoSizeTextEdit::splitMarkers() const
+{
+    QList<int> positions{};
+    auto length = document()->characterCount() - 1;
+
+    for (auto& marker : splitMarkers_)
+    {
+        auto position = marker.position();
+
+        if (position > 0 && position < length && !positions.contains(position))
+            positions << position;
+    }
+
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+void AutoSizeTextEdit::toggleSplitMarker()
+{
+    auto position = textCursor().position();
+    auto removed = false;
+
+    for (auto i = splitMarkers_.count() - 1; i >= 0; --i)
+    {
+        if (splitMarkers_.at(i).position() != position) continue;
+
+        splitMarkers_.removeAt(i);
+        removed = true;
+    }
+
+    if (!removed)
+    {
+        QTextCursor marker(document());
+        marker.setPosition(position);
+        splitMarkers_ << marker;
+    }
+
+    updateSplitMarkerSelections_();
+}
+
+void AutoSizeTextEdit::clearSplitMarkers()
+{
+    if (splitMarkers_.isEmpty()) return;
+
+    splitMarkers_.clear();
+    updateSplitMarkerSelections_();
+}
+
+void AutoSizeTextEdit::setSplitMarkers_(const QList<int>& positions)
+{
+    splitMarkers_.clear();
+
+    for (auto position : positions)
+    {
+        QTextCursor marker(document());
+        marker.setPosition(position);
+        splitMarkers_ << marker;
+    }
+
+    updateSplitMarkerSelections_();
+}
+
+void AutoSizeTextEdit::updateSplitMarkerSelections_()
+{
+    // Highlights the character right after each marker (the first character
+    // of the piece it would start)
+    QList<ExtraSelection> selections{};
+    auto color = palette().color(QPalette::Highlight);
+    color.setAlpha(96);
+
+    for (auto position : splitMarkers())
+    {
+        ExtraSelection selection{};
+        selection.cursor = QTextCursor(document());
+        selection.cursor.setPosition(position);
+        selection.cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor);
+        selection.format.setBackground(color);
+        selections << selection;
+    }
+
+    setExtraSelections(selections);
+}
+
+void AutoSizeTextEdit::reflow()
+{
+    if (!reflowPending_) return;
+    reflowPending_ = false;
+
+    // QTextEdit only relays out the document if the width differs from the
+    // old size, so hand it the one from before we started deferring
+    QResizeEvent event(size(), deferredOldSize_);
+    QTextEdit::resizeEvent(&event);
+    updateHeight_();
+}
+
+void AutoSizeTextEdit::resizeEvent(QResizeEvent* event)
+{
+    // Laying out the document again for a new width is the expensive part of
+    // a resize, and with thousands of these in the view, dragging the window
+    // edge would stutter. So, if we're off screen, put it off. (The old
+    // width is invalid for the first resize after being shown, and that one
+    // is never put off)
+    auto old_width = event->oldSize().width();
+    auto width_changed = old_width > 0 && old_width != event->size().width();
+
+    if ((reflowPending_ || (width_changed && measuredTextWidth_ > 0))
+        && visibleRegion().isEmpty())
+    {
+        if (!reflowPending_)
+        {
+            reflowPending_ = true;
+            deferredOldSize_ = event->oldSize();
+            emit reflowDeferred();
+        }
+
+        estimateHeight_();
+        return;
+    }
+
+    if (reflowPending_)
+    {
+        reflow();
+        return;
+    }
+
+    QTextEdit::resizeEvent(event);
+    updateHeight_();
 }
 
 void AutoSizeTextEdit::mousePressEvent(QMouseEvent* event)
@@ -187,6 +304,36 @@ void AutoSizeTextEdit::keyPressEvent(QKeyEvent* event)
         event->ignore();
         return;
 
+        // Ctrl + Enter inserts a new element after this one (the keyboard
+        // counterpart to the insert button)
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        if (event->modifiers() & Qt::ControlModifier)
+        {
+            emit insertRequested();
+            event->accept();
+            return;
+        }
+
+        QTextEdit::keyPressEvent(event);
+        break;
+
+    case Qt::Key_M:
+        if (event->modifiers() & Qt::ControlModifier)
+        {
+            toggleSplitMarker();
+            event->accept();
+            return;
+        }
+
+        QTextEdit::keyPressEvent(event);
+        break;
+
+    case Qt::Key_Escape:
+        clearSplitMarkers();
+        QTextEdit::keyPressEvent(event);
+        break;
+
     default:
         QTextEdit::keyPressEvent(event);
     }
@@ -194,20 +341,64 @@ void AutoSizeTextEdit::keyPressEvent(QKeyEvent* event)
 
 void AutoSizeTextEdit::updateHeight_()
 {
-    // Only calculate document size when content actually changes, otherwise
-    // we'll get a lof memory usage with repeat scrolling
-    static auto last_text_length = 0;
-    auto current_text_length = toPlainText().length();
-    if (last_text_length == current_text_length) return;
+    ++counters().heightUpdates;
+
+    // The text changed while we were waiting to reflow, so the layout at the
+    // old width is no good anymore either
+    if (reflowPending_)
+    {
+        reflow();
+        return;
+    }
 
-    last_text_length = current_text_length;
+    // Laying out while hidden would be at whatever width we happen to have,
+    // and we'd just do it again once shown
+    if (!isVisible())
+    {
+        measurePending_ = true;
+        return;
+    }
+
+    measurePending_ = false;
+
+    // Only calculate document size when content or width actually changes,
+    // otherwise we'll get a lof memory usage with repeat scrolling. (This
+    // used to be one static text length shared by every instance)
+    auto doc = document();
+    auto revision = doc->revision();
+    auto text_width = viewport()->width();
+    if (revision == measuredRevision_ && text_width == measuredTextWidth_) return;
+
+    measuredRevision_ = revision;
+    measuredTextWidth_ = text_width;
 
     // Get the document's size for the current width
-    auto doc_size = document()->size().toSize();
+    ++counters().layouts;
+    measuredDocHeight_ = doc->size().toSize().height();
+    auto y = heightFor_(measuredDocHeight_);
+
+    // Keep the estimates honest
+    if (!doc->isEmpty())
+    {
+        auto doc_margins = doc->documentMargin() * 2;
+
+        HeightEstimator::forFont(font()).correct
+        (
+            currentWords_(),
+            text_width - doc_margins,
+            measuredDocHeight_ - doc_margins
+        );
+    }
+
+    // Only update if height actually changed to avoid infinite resize loops
+    if (y != height())
+        setFixedHeight(y);
+}
 
-    // Calculate height
+int AutoSizeTextEdit::heightFor_(int documentHeight) const
+{
     auto margins = contentsMargins();
-    auto y = doc_size.height()
+    auto y = documentHeight
         + margins.top()
         + margins.bottom();
 
@@ -215,11 +406,45 @@ void AutoSizeTextEdit::updateHeight_()
     if (frameWidth() > 0)
         y += frameWidth() * 2;
 
-    // Only update if height actually changed to avoid infinite resize loops
+    return y;
+}
+
+void AutoSizeTextEdit::estimateHeight_()
+{
+    auto doc_margins = document()->documentMargin() * 2;
+    auto text_width = viewport()->width() - doc_margins;
+
+    auto text_height = HeightEstimator::forFont(font())
+        .height(currentWords_(), text_width);
+
+    auto y = heightFor_(qCeil(text_height + doc_margins));
+
     if (y != height())
         setFixedHeight(y);
 }
 
+void AutoSizeTextEdit::loadPlainText(const QString& text)
+{
+    setPlainText(text);
+    words_ = HeightEstimator::forFont(font()).words(text);
+    wordsRevision_ = document()->revision();
+}
+
+const HeightEstimator::Words& AutoSizeTextEdit::currentWords_()
+{
+    auto doc = document();
+    auto revision = doc->revision();
+
+    if (revision != wordsRevision_)
+    {
+        ++counters().plainTextCopies;
+        words_ = HeightEstimator::forFont(font()).words(doc->toPlainText());
+        wordsRevision_ = revision;
+    }
+
+    return words_;
+}
+
 void AutoSizeTextEdit::setCursorIfNoSelection_(QMouseEvent* event)
 {
     auto cursor = textCursor();
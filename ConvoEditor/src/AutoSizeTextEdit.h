@@ -2,13 +2,20 @@
 
 #include <QFocusEvent>
 #include <QKeyEvent>
+#include <QList>
 #include <QMouseEvent>
 #include <QObject>
 #include <QResizeEvent>
+#include <QShowEvent>
+#include <QSize>
+#include <QTextCursor>
 #include <QTextEdit>
+#include <QtTypes>
 #include <QWheelEvent>
 #include <QWidget>
 
+#include "HeightEstimator.h"
+
 // Why doesn't this work with QPlainTextEdit?
 // Set max auto height to begin using scroll bar instead
 class AutoSizeTextEdit : public QTextEdit
@@ -19,23 +26,60 @@ public:
     explicit AutoSizeTextEdit(QWidget* parent = nullptr);
     virtual ~AutoSizeTextEdit() override;
 
+    // Across all instances, for the latency benchmark (see Bench)
+    struct Counters
+    {
+        qint64 heightUpdates = 0;
+        qint64 layouts = 0;
+
+        // Text copied back out of the document for height estimates
+        qint64 plainTextCopies = 0;
+    };
+
+    static Counters& counters() noexcept
+    {
+        static Counters counters{};
+        return counters;
+    }
+
     void simplify();
 
+    // setPlainText, but the words for height estimates are worked out from
+    // text, instead of copying it back out of the document for them later
+    void loadPlainText(const QString& text);
+
+    // Split markers (toggled with Ctrl+M) let one split cut the text in
+    // several places at once. They follow edits. Returned sorted, without
+    // duplicates or positions at either end
+    QList<int> splitMarkers() const;
+    void toggleSplitMarker();
+    void clearSplitMarkers();
+
+    // Resizes (well, width changes) off screen don't lay out the document
+    // right away; the height is estimated until this is called. Does
+    // nothing if there's nothing pending
+    void reflow();
+    bool reflowPending() const noexcept { return reflowPending_; }
+
 signals:
     void rockeredLeft();
     void rockeredRight();
     void middleClicked();
     void mouseChorded(int key, Qt::KeyboardModifiers modifiers);
+    void insertRequested();
+    void reflowDeferred();
 
 protected:
     virtual void mousePressEvent(QMouseEvent* event) override;
     virtual void mouseReleaseEvent(QMouseEvent* event) override;
     virtual void keyPressEvent(QKeyEvent* event) override;
 
-    virtual void resizeEvent(QResizeEvent* event) override
+    virtual void resizeEvent(QResizeEvent* event) override;
+
+    virtual void showEvent(QShowEvent* event) override
     {
-        QTextEdit::resizeEvent(event);
-        updateHeight_();
+        QTextEdit::showEvent(event);
+        if (measurePending_) updateHeight_();
     }
 
     virtual void focusOutEvent(QFocusEvent* event) override
@@ -55,6 +99,30 @@ private:
     bool mmbPressed_ = false;
     bool rmbPressed_ = false;
 
+    QList<QTextCursor> splitMarkers_{};
+
+    bool reflowPending_ = false;
+    QSize deferredOldSize_{};
+
+    // Last real measurement, for skipping redundant ones and for estimates
+    int measuredRevision_ = -1;
+    int measuredTextWidth_ = -1;
+    int measuredDocHeight_ = 0;
+
+    // Text changes while hidden (e.g. being populated) are measured once
+    // we're shown, at the width we're shown at
+    bool measurePending_ = false;
+
+    // For HeightEstimator, redone when the text changes
+    HeightEstimator::Words words_{};
+    int wordsRevision_ = -1;
+
+    const HeightEstimator::Words& currentWords_();
+    void setSplitMarkers_(const QList<int>& positions);
+    void updateSplitMarkerSelections_();
+    int heightFor_(int documentHeight) const;
+    void estimateHeight_();
+
 private slots:
     void updateHeight_();
     void setCursorIfNoSelection_(QMouseEvent* event);
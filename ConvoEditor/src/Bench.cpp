@@ -0,0 +1,787 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QKeyEvent>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QPoint>
+#include <QPointF>
+#include <QScrollBar>
+#include <QTextCursor>
+#include <QtTypes>
+#include <QWheelEvent>
+
+#include "Coco/Io.h"
+#include "Coco/Path.h"
+
+#include "AutoSizeTextEdit.h"
+#include "Bench.h"
+#include "Element.h"
+#include "Eot.h"
+#include "Keys.h"
+#include "LoadPlan.h"
+#include "RoleStats.h"
+#include "Simd.h"
+#include "Utility.h"
+#include "View.h"
+
+// Allocation counting for runKernels. Debug MSVC builds hook the debug CRT
+// heap, which Qt's debug DLLs share, so that counts everything. Otherwise,
+// CONVO_BENCH_ALLOCS replaces the global operator new, which only sees
+// allocations made from this executable (not Qt's own mallocs)
+#if defined(_MSC_VER) && defined(_DEBUG)
+#include <crtdbg.h>
+#define BENCH_CRT_ALLOCS_
+#elif defined(CONVO_BENCH_ALLOCS)
+#define BENCH_NEW_ALLOCS_
+#endif
+
+namespace
+{
+    std::atomic<qint64> allocations_{ 0 };
+}
+
+#if defined(BENCH_NEW_ALLOCS_)
+
+void* operator new(std::size_t size)
+{
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    if (auto p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#endif // BENCH_NEW_ALLOCS_
+
+namespace
+{
+#if defined(BENCH_CRT_ALLOCS_)
+
+    int countCrtAllocation_(int allocType, void*, std::size_t, int blockType, long, const unsigned char*, int)
+    {
+        // The CRT's own bookkeeping isn't ours (or Qt's)
+        if (blockType != _CRT_BLOCK && (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC))
+            allocations_.fetch_add(1, std::memory_order_relaxed);
+
+        // (Let the allocation go ahead)
+        return 1;
+    }
+
+#endif // BENCH_CRT_ALLOCS_
+
+    // Installs the CRT hook (if there is one) for its lifetime
+    class AllocationCounting
+    {
+    public:
+        AllocationCounting()
+        {
+#if defined(BENCH_CRT_ALLOCS_)
+            previous_ = _CrtSetAllocHook(countCrtAllocation_);
+#endif
+        }
+
+        ~AllocationCounting()
+        {
+#if defined(BENCH_CRT_ALLOCS_)
+            _CrtSetAllocHook(previous_);
+#endif
+        }
+
+        AllocationCounting(const AllocationCounting&) = delete;
+        AllocationCounting& operator=(const AllocationCounting&) = delete;
+
+        // What count() covers: "all" (the whole CRT heap), "app" (operator
+        // new in this executable only), or nullptr if it isn't counted
+        static const char* scope() noexcept
+        {
+#if defined(BENCH_CRT_ALLOCS_)
+            return "all";
+#elif defined(BENCH_NEW_ALLOCS_)
+            return "app";
+#else
+            return nullptr;
+#endif
+        }
+
+        static qint64 count() noexcept { return allocations_.load(std::memory_order_relaxed); }
+
+    private:
+#if defined(BENCH_CRT_ALLOCS_)
+        _CRT_ALLOC_HOOK previous_ = nullptr;
+#endif
+    };
+
+    bool openOut_(QFile& out, const QString& path)
+    {
+        if (path.isEmpty())
+            return out.open(stdout, QIODevice::WriteOnly);
+
+        out.setFileName(path);
+        return out.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+
+    void writeLine_(QFile& out, const QJsonObject& line)
+    {
+        out.write(QJsonDocument(line).toJson(QJsonDocument::Compact));
+        out.write("\n");
+        out.flush();
+    }
+
+    // Some short, some long, a few contractions (for wouldBreakWord)
+    constexpr const char* WORDS_[] =
+    {
+        "the", "a", "and", "so", "I", "you", "we", "it's", "don't", "that",
+        "think", "really", "going", "know", "actually", "about", "people",
+        "something", "transcript", "conversation", "probably", "wasn't",
+        "yesterday", "meeting", "anyway", "because", "right", "okay", "just",
+        "interesting", "recording", "speaker", "question", "everybody"
+    };
+
+    constexpr const char* FILLERS_[] = { "um", "uh", "hmm" };
+
+    double toMs_(qint64 nanoseconds)
+    {
+        return nanoseconds / 1'000'000.0;
+    }
+
+    // Handles whatever is posted or due (layout, deferred slots) in one pass
+    qint64 settle_()
+    {
+        QElapsedTimer timer{};
+        timer.start();
+        QCoreApplication::sendPostedEvents();
+        QCoreApplication::processEvents();
+        return timer.nsecsElapsed();
+    }
+
+    // Nearest rank
+    double percentile_(QList<qint64> samples, double p)
+    {
+        if (samples.isEmpty()) return 0.0;
+
+        std::sort(samples.begin(), samples.end());
+        auto rank = static_cast<qsizetype>(std::ceil(p * samples.count())) - 1;
+        return toMs_(samples.at(qBound<qsizetype>(0, rank, samples.count() - 1)));
+    }
+
+    QJsonObject latencyLine_(const char* name, int turns, const QList<qint64>& samples)
+    {
+        QJsonObject line{};
+        line["bench"] = name;
+        line["turns"] = turns;
+        line["events"] = static_cast<qint64>(samples.count());
+        line["p50Ms"] = percentile_(samples, 0.50);
+        line["p99Ms"] = percentile_(samples, 0.99);
+        line["maxMs"] = percentile_(samples, 1.0);
+        return line;
+    }
+
+    class Generator
+    {
+    public:
+        explicit Generator(const Bench::Options& options)
+            : options_(options), random_(options.seed)
+        {
+        }
+
+        int wordCount()
+        {
+            auto mean = qMax(1, options_.meanWords);
+
+            switch (options_.distribution)
+            {
+            default:
+            case Bench::Distribution::Constant:
+                return mean;
+
+            case Bench::Distribution::Uniform:
+                return std::uniform_int_distribution<int>(1, (mean * 2) - 1)(random_);
+
+            case Bench::Distribution::LogNormal:
+            {
+                // Mostly short turns with a long tail, like real ASR output
+                constexpr auto sigma = 0.8;
+                auto mu = std::log(static_cast<double>(mean)) - (sigma * sigma / 2.0);
+                auto count = std::lognormal_distribution<double>(mu, sigma)(random_);
+                return qMax(1, static_cast<int>(std::lround(count)));
+            }
+            }
+        }
+
+        QString speech(int words, bool& eot)
+        {
+            QString speech{};
+            auto sentence_left = 0;
+
+            for (auto i = 0; i < words; ++i)
+            {
+                auto starts_sentence = sentence_left == 0;
+                if (starts_sentence) sentence_left = pick_(4, 15);
+
+                QString word(pick_(WORDS_));
+                if (starts_sentence) word[0] = word.at(0).toUpper();
+
+                if (!speech.isEmpty()) speech += ' ';
+                speech += word;
+
+                if (--sentence_left == 0 || i == words - 1)
+                {
+                    auto roll = pick_(0, 9);
+                    speech += (roll < 7) ? "." : (roll < 9) ? "?" : "!";
+                    sentence_left = 0;
+                }
+                else if (pick_(0, 11) == 0)
+                {
+                    speech += ',';
+                }
+            }
+
+            // Some turns trail off (and so don't end)
+            eot = pick_(0, 5) != 0;
+
+            if (!eot)
+            {
+                if (speech.endsWith('.')) speech.chop(1);
+                speech += ", ";
+                speech += pick_(FILLERS_);
+            }
+
+            return speech;
+        }
+
+        int role(int previous)
+        {
+            auto roles = qMax(1, options_.roles);
+            if (roles == 1) return 0;
+
+            // Usually a different speaker than last time
+            if (previous >= 0 && pick_(0, 9) < 3) return previous;
+
+            auto role = pick_(0, roles - 2);
+            return (previous >= 0 && role >= previous) ? role + 1 : role;
+        }
+
+    private:
+        Bench::Options options_;
+        std::mt19937 random_;
+
+        int pick_(int min, int max)
+        {
+            return std::uniform_int_distribution<int>(min, max)(random_);
+        }
+
+        template <std::size_t N>
+        const char* pick_(const char* const (&from)[N])
+        {
+            return from[pick_(0, static_cast<int>(N) - 1)];
+        }
+    };
+}
+
+Bench::Distribution Bench::distribution(const QString& name)
+{
+    auto lower = name.toLower();
+    if (lower == "constant") return Distribution::Constant;
+    if (lower == "uniform") return Distribution::Uniform;
+    return Distribution::LogNormal;
+}
+
+QJsonDocument Bench::generate(const Options& options)
+{
+    Generator generator(options);
+    QJsonArray results{};
+    auto role = -1;
+
+    for (auto i = 0; i < options.turns; ++i)
+    {
+        role = generator.role(role);
+        auto eot = true;
+        auto speech = generator.speech(generator.wordCount(), eot);
+
+        QJsonObject turn{};
+        turn[Keys::ROLE] = QString("Speaker %1").arg(role);
+        turn[Keys::SPEECH] = speech;
+        turn[Keys::EOT] = eot;
+        results << turn;
+    }
+
+    QJsonObject root{};
+    root[Keys::RESULTS_ARRAY] = results;
+    return QJsonDocument(root);
+}
+
+bool Bench::generate(const Options& options, const Coco::Path& path)
+{
+    return Coco::Io::Json::write(generate(options), path);
+}
+
+int Bench::run(const QList<int>& turnCounts, Options options, const QString& outPath)
+{
+    QFile out{};
+
+    if (!openOut_(out, outPath))
+    {
+        qWarning() << "Couldn't open benchmark output:" << outPath;
+        return 1;
+    }
+
+    QTemporaryDir dir{};
+
+    if (!dir.isValid())
+    {
+        qWarning() << "Couldn't create a temporary directory";
+        return 1;
+    }
+
+    auto record = [&](const char* name, int turns, qint64 nanoseconds, qint64 settleNanoseconds, int ops = 1)
+        {
+            QJsonObject line{};
+            line["bench"] = name;
+            line["turns"] = turns;
+            line["roles"] = options.roles;
+            line["meanWords"] = options.meanWords;
+            line["ops"] = ops;
+            line["ms"] = toMs_(nanoseconds) / qMax(1, ops);
+            line["settleMs"] = toMs_(settleNanoseconds);
+            writeLine_(out, line);
+        };
+
+    QElapsedTimer timer{};
+
+    for (auto turns : turnCounts)
+    {
+        options.turns = turns;
+        auto path = dir.filePath(QString("bench-%1.json").arg(turns));
+
+        if (!generate(options, path))
+        {
+            qWarning() << "Couldn't write generated document:" << path;
+            return 1;
+        }
+
+        View view{};
+        view.resize(1000, 800);
+        view.show();
+        settle_();
+
+        // Whole load, as a user would see it
+        LoadPlan::counters() = {};
+        auto plain_text_copies_before = AutoSizeTextEdit::counters().plainTextCopies;
+        timer.start();
+        if (!view.load(path)) return 1;
+        auto elapsed = timer.nsecsElapsed();
+        record("load", turns, elapsed, settle_());
+
+        // Copies made by the load, with everything it set off (the search
+        // index build, first measurements) finished
+        while (!view.searchIndexReady_)
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+
+        settle_();
+        auto text_copies = LoadPlan::counters().textCopies
+            + (AutoSizeTextEdit::counters().plainTextCopies - plain_text_copies_before);
+
+        auto copies_per_turn = static_cast<double>(text_copies) / qMax(1, turns);
+
+        QJsonObject copies{};
+        copies["bench"] = "textCopies";
+        copies["turns"] = turns;
+        copies["perTurn"] = copies_per_turn;
+        copies["max"] = LoadPlan::MAX_TEXT_COPIES_PER_TURN;
+        writeLine_(out, copies);
+
+        if (copies_per_turn > LoadPlan::MAX_TEXT_COPIES_PER_TURN)
+        {
+            qWarning() << "Text copied" << copies_per_turn << "times per turn on load (max"
+                << LoadPlan::MAX_TEXT_COPIES_PER_TURN << ")";
+            return 1;
+        }
+
+        // And its stages on their own
+        timer.start();
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) return 1;
+        auto json = file.readAll();
+        record("read", turns, timer.nsecsElapsed(), 0);
+
+        timer.start();
+        auto plan = view.parse_(json);
+        record("parse", turns, timer.nsecsElapsed(), 0);
+
+        {
+            View scratch{};
+            timer.start();
+            scratch.populate_(plan);
+            record("populate", turns, timer.nsecsElapsed(), settle_());
+        }
+
+        timer.start();
+        view.save();
+        record("save", turns, timer.nsecsElapsed(), 0);
+
+        timer.start();
+        view.autoEot();
+        elapsed = timer.nsecsElapsed();
+        record("autoEot", turns, elapsed, settle_());
+
+        // Bipart splits, spread over the document, from the middle of each
+        // element's text
+        auto split_count = qMin(100, static_cast<int>(view.elements_.count()));
+        auto stride = qMax(1, static_cast<int>(view.elements_.count()) / qMax(1, split_count));
+        QList<Element*> to_split{};
+
+        for (auto i = 0; i < split_count; ++i)
+            to_split << view.elements_.at(i * stride);
+
+        qint64 split_elapsed = 0;
+
+        for (auto& element : to_split)
+        {
+            auto edit = element->speechEdit();
+            auto cursor = edit->textCursor();
+            cursor.setPosition(edit->toPlainText().length() / 2);
+            edit->setTextCursor(cursor);
+            view.currentEdit_ = edit;
+
+            timer.start();
+            view.split();
+            split_elapsed += timer.nsecsElapsed();
+        }
+
+        record("split", turns, split_elapsed, settle_(), split_count);
+
+        if (!view.roleChoices_.isEmpty())
+        {
+            timer.start();
+            view.onElementRoleChangeRequested_(view.roleChoices_.first(), "Renamed");
+            elapsed = timer.nsecsElapsed();
+            record("roleRename", turns, elapsed, settle_());
+        }
+    }
+
+    return 0;
+}
+
+int Bench::runKernels(const QString& outPath)
+{
+    QFile out{};
+
+    if (!openOut_(out, outPath))
+    {
+        qWarning() << "Couldn't open benchmark output:" << outPath;
+        return 1;
+    }
+
+    // Realistic turns come from the generator. The rest are the sort of
+    // thing that's slow or wrong in practice
+    Options options{};
+    options.meanWords = 20;
+    Generator generator(options);
+    auto eot = true;
+
+    QStringList realistic{};
+    for (auto i = 0; i < 64; ++i)
+        realistic << generator.speech(generator.wordCount(), eot);
+
+    QStringList long_speeches{};
+    for (auto i = 0; i < 4; ++i)
+        long_speeches << generator.speech(5000, eot);
+
+    QStringList punctuation
+    {
+        "Wait... what?! No -- no, no, no!!! \"Really?!\" she said... um...",
+        "...?!...?!... '' \"\" -- ... !!!",
+        "It's Jim's--and Sam's--y'all's 'thing', isn't it? 'Course.",
+        "(a) [b] {c} <d> -- e; f: g, h. i! j? k... l--"
+    };
+
+    QStringList non_latin
+    {
+        QString::fromUtf8("Привет, как дела? Хорошо, спасибо. А у тебя?"),
+        QString::fromUtf8("你好，你今天怎么样？我很好，谢谢。你呢？"),
+        QString::fromUtf8("مرحبا، كيف حالك؟ أنا بخير، شكرا. وأنت؟"),
+        QString::fromUtf8("こんにちは。元気ですか？ええ、元気です、ありがとう。")
+    };
+
+    QStringList whitespace{};
+    for (auto& speech : std::as_const(realistic))
+        whitespace << QString("  \t") + QString(speech).replace(' ', "   \n ") + "\t  ";
+
+    struct Input
+    {
+        const char* name;
+        const QStringList* texts;
+    };
+
+    const QList<Input> inputs
+    {
+        { "realistic", &realistic },
+        { "long", &long_speeches },
+        { "punctuation", &punctuation },
+        { "nonLatin", &non_latin },
+        { "whitespace", &whitespace }
+    };
+
+    // Something for results to go into, so the work isn't optimized away
+    volatile qsizetype sink = 0;
+    AllocationCounting allocation_counting{};
+
+    // Runs op over the texts (round robin) for at least MIN_NS_
+    auto measure = [&](const char* kernel, const Input& input, auto op)
+        {
+            constexpr qint64 MIN_NS_ = 200'000'000;
+            const auto& texts = *input.texts;
+
+            // Warm up
+            for (auto& text : texts)
+                sink = sink + op(text);
+
+            qint64 ops = 0;
+            auto allocations_before = AllocationCounting::count();
+            QElapsedTimer timer{};
+            timer.start();
+
+            while (timer.nsecsElapsed() < MIN_NS_)
+            {
+                for (auto& text : texts)
+                    sink = sink + op(text);
+
+                ops += texts.count();
+            }
+
+            auto elapsed = timer.nsecsElapsed();
+            auto allocations = AllocationCounting::count() - allocations_before;
+
+            QJsonObject line{};
+            line["kernel"] = kernel;
+            line["input"] = input.name;
+            line["simd"] = Simd::instructionSet();
+            line["ops"] = ops;
+            line["nsPerOp"] = static_cast<double>(elapsed) / qMax<qint64>(1, ops);
+
+            if (auto scope = AllocationCounting::scope())
+            {
+                line["allocsPerOp"] = static_cast<double>(allocations) / qMax<qint64>(1, ops);
+                line["allocsCounted"] = scope;
+            }
+            else
+            {
+                line["allocsPerOp"] = QJsonValue::Null;
+            }
+
+            writeLine_(out, line);
+        };
+
+    for (auto& input : inputs)
+    {
+        // Every position, like a pass over a turn would
+        measure("wouldBreakWord", input, [](const QString& text)
+            {
+                qsizetype breaks = 0;
+
+                for (auto i = 1; i < text.length(); ++i)
+                    breaks += Utility::wouldBreakWord(text, i);
+
+                return breaks;
+            });
+
+        measure("shiftPunct", input, [](const QString& text)
+            {
+                auto middle = text.length() / 2;
+                auto before = text.left(middle);
+                auto after = text.mid(middle);
+                Utility::shiftPunct(before, after);
+                return before.length();
+            });
+
+        measure("applyBreakIndicators", input, [](const QString& text)
+            {
+                auto middle = text.length() / 2;
+                auto before = text.left(middle);
+                auto after = text.mid(middle);
+                Utility::applyBreakIndicators(before, after);
+                return after.length();
+            });
+
+        measure("endsWithFiller", input, [](const QString& text)
+            {
+                return static_cast<qsizetype>(Eot::endsWithFiller(text));
+            });
+
+        measure("hasTerminalPunct", input, [](const QString& text)
+            {
+                return static_cast<qsizetype>(Eot::hasTerminalPunct(text));
+            });
+
+        measure("simplifiedPositions", input, [](const QString& text)
+            {
+                return Utility::simplifiedPositions(text).count();
+            });
+
+        // Against Qt's own, for comparison
+        measure("simplified", input, [](const QString& text)
+            {
+                return Utility::simplified(text).length();
+            });
+
+        measure("qtSimplified", input, [](const QString& text)
+            {
+                return text.simplified().length();
+            });
+
+        measure("countWords", input, [](const QString& text)
+            {
+                return RoleStats::countWords(text);
+            });
+    }
+
+    return 0;
+}
+
+int Bench::runLatency(const QList<int>& turnCounts, Options options, const QString& outPath)
+{
+    QFile out{};
+
+    if (!openOut_(out, outPath))
+    {
+        qWarning() << "Couldn't open benchmark output:" << outPath;
+        return 1;
+    }
+
+    QTemporaryDir dir{};
+
+    if (!dir.isValid())
+    {
+        qWarning() << "Couldn't create a temporary directory";
+        return 1;
+    }
+
+    constexpr auto KEYSTROKES_ = 500;
+    constexpr auto WHEEL_STEPS_ = 300;
+    QElapsedTimer timer{};
+
+    for (auto turns : turnCounts)
+    {
+        options.turns = turns;
+        auto path = dir.filePath(QString("latency-%1.json").arg(turns));
+
+        if (!generate(options, path))
+        {
+            qWarning() << "Couldn't write generated document:" << path;
+            return 1;
+        }
+
+        View view{};
+        view.resize(1000, 800);
+        view.show();
+        if (!view.load(path)) return 1;
+        settle_();
+
+        if (view.elements_.isEmpty()) continue;
+
+        // Type into the middle of the document, at the end of a turn (the
+        // usual place), one press & release per character
+        auto element = view.elements_.at(view.elements_.count() / 2);
+        view.jumpTo_(element);
+        settle_();
+
+        auto edit = element->speechEdit();
+        edit->setFocus();
+        auto cursor = edit->textCursor();
+        cursor.movePosition(QTextCursor::End);
+        edit->setTextCursor(cursor);
+
+        QList<qint64> samples{};
+        samples.reserve(KEYSTROKES_);
+        auto counters_before = AutoSizeTextEdit::counters();
+        const QString typed("the quick brown fox jumps over the lazy dog ");
+
+        for (auto i = 0; i < KEYSTROKES_; ++i)
+        {
+            auto c = typed.at(i % typed.length());
+            auto key = (c == ' ') ? Qt::Key_Space : static_cast<Qt::Key>(Qt::Key_A + (c.unicode() - 'a'));
+
+            QKeyEvent press(QEvent::KeyPress, key, Qt::NoModifier, QString(c));
+            QKeyEvent release(QEvent::KeyRelease, key, Qt::NoModifier, QString(c));
+
+            timer.start();
+            QCoreApplication::sendEvent(edit, &press);
+            QCoreApplication::sendEvent(edit, &release);
+            settle_();
+            samples << timer.nsecsElapsed();
+        }
+
+        auto counters = AutoSizeTextEdit::counters();
+        auto typing = latencyLine_("typing", turns, samples);
+
+        typing["heightUpdatesPerEvent"] =
+            static_cast<double>(counters.heightUpdates - counters_before.heightUpdates) / KEYSTROKES_;
+
+        typing["layoutsPerEvent"] =
+            static_cast<double>(counters.layouts - counters_before.layouts) / KEYSTROKES_;
+
+        writeLine_(out, typing);
+
+        // Wheel down from the top, a notch at a time
+        view.jumpTo_(view.elements_.first());
+        settle_();
+
+        samples.clear();
+        samples.reserve(WHEEL_STEPS_);
+        auto viewport = view.scrollArea_->viewport();
+        QPointF center(viewport->width() / 2.0, viewport->height() / 2.0);
+        counters_before = AutoSizeTextEdit::counters();
+
+        for (auto i = 0; i < WHEEL_STEPS_; ++i)
+        {
+            QWheelEvent wheel
+            (
+                center,
+                viewport->mapToGlobal(center),
+                QPoint(),
+                QPoint(0, -120),
+                Qt::NoButton,
+                Qt::NoModifier,
+                Qt::NoScrollPhase,
+                false
+            );
+
+            timer.start();
+            QCoreApplication::sendEvent(viewport, &wheel);
+            settle_();
+            samples << timer.nsecsElapsed();
+        }
+
+        counters = AutoSizeTextEdit::counters();
+        auto scroll = latencyLine_("scroll", turns, samples);
+
+        scroll["layoutsPerEvent"] =
+            static_cast<double>(counters.layouts - counters_before.layouts) / WHEEL_STEPS_;
+
+        scroll["endValue"] = view.scrollArea_->verticalScrollBar()->value();
+        writeLine_(out, scroll);
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QJsonDocument>
+#include <QList>
+#include <QString>
+#include <QtTypes>
+
+#include "Coco/Path.h"
+
+// Synthetic transcripts and end-to-end timings, so performance work has
+// numbers to go on. Both are run from the command line (see Main.cpp) and
+// work under QT_QPA_PLATFORM=offscreen. Results are written as JSON lines,
+// one per measurement
+class Bench
+{
+public:
+    enum class Distribution
+    {
+        Constant,
+        Uniform,
+        LogNormal
+    };
+
+    struct Options
+    {
+        int turns = 1000;
+        int roles = 2;
+        int meanWords = 20;
+        Distribution distribution = Distribution::LogNormal;
+        quint32 seed = 1;
+    };
+
+    static Distribution distribution(const QString& name);
+
+    static QJsonDocument generate(const Options& options);
+    static bool generate(const Options& options, const Coco::Path& path);
+
+    // Return an exit code. An empty outPath means stdout
+    static int run(const QList<int>& turnCounts, Options options, const QString& outPath = {});
+
+    // Microbenchmarks for the per-turn text functions (Utility, Eot, and
+    // simplify's position mapping), in ns/op. Allocations per op are
+    // counted in Debug MSVC builds (all of them, Qt's included) and in
+    // builds with CONVO_BENCH_ALLOCS defined (app-side operator new only;
+    // allocsCounted says which), and are null otherwise
+    static int runKernels(const QString& outPath = {});
+
+    // Per-event latency (p50/p99/max, including handling whatever the event
+    // posted) for typing into a turn and wheel scrolling, plus how many
+    // height updates and layouts each keystroke caused
+    static int runLatency(const QList<int>& turnCounts, Options options, const QString& outPath = {});
+};
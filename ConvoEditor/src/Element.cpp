@@ -1,4 +1,3 @@
-#include <QDebug>
 #include <QHBoxLayout>
 #include <QToolButton>
 #include <QVBoxLayout>
@@ -9,17 +8,20 @@
 #include "AutoSizeTextEdit.h"
 #include "Element.h"
 #include "EotCheck.h"
+#include "Logging.h"
 #include "RoleSelector.h"
 
 Element::Element(QWidget* parent)
     : QWidget(parent)
 {
+    ++instances_;
     initialize_();
 }
 
 Element::~Element()
 {
-    qDebug() << __FUNCTION__;
+    --instances_;
+    qCDebug(lcLifetime) << __FUNCTION__;
 }
 
 void Element::initialize_()
@@ -94,6 +96,30 @@ void Element::initialize_()
         &Element::onRoleSelectorIndexChanged_
     );
 
+    connect
+    (
+        roleSelector_,
+        &RoleSelector::currentTextChanged,
+        this,
+        [&] { emit roleChanged(this); }
+    );
+
+    connect
+    (
+        speechEdit_,
+        &AutoSizeTextEdit::textChanged,
+        this,
+        [&] { emit speechChanged(this); }
+    );
+
+    connect
+    (
+        eotCheck_,
+        &EotCheck::toggled,
+        this,
+        [&] { emit eotChanged(this); }
+    );
+
     connect
     (
         delete_,
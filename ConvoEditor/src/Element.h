@@ -13,12 +13,14 @@
 #include <QStringList>
 #include <QToolButton>
 #include <QVBoxLayout>
+#include <QtTypes>
 #include <QWidget>
 
 #include "Coco/Fx.h"
 
 #include "AutoSizeTextEdit.h"
 #include "EotCheck.h"
+#include "LoadPlan.h"
 #include "RoleSelector.h"
 #include "Utility.h"
 
@@ -34,16 +36,24 @@ public:
     explicit Element(QWidget* parent = nullptr);
     virtual ~Element() override;
 
+    // Live ones, including any waiting to be torn down
+    static qsizetype instances() noexcept { return instances_; }
+
     QString role() const { return roleSelector_->currentText(); }
     void setRole(const QString& role) { roleSelector_->setCurrentText(role); }
     QString speech() const { return speechEdit_->toPlainText(); }
-    void setSpeech(const QString& speech) { speechEdit_->setPlainText(speech); }
+    void setSpeech(const QString& speech) { speechEdit_->loadPlainText(speech); }
     bool eot() const { return eotCheck_->isChecked(); }
     void setEot(bool eot) { eotCheck_->setChecked(eot); }
     RoleSelector* roleSelector() const noexcept { return roleSelector_; }
     AutoSizeTextEdit* speechEdit() const noexcept { return speechEdit_; }
     EotCheck* eotCheck() const noexcept { return eotCheck_; }
 
+    // Whatever else the turn had in the file, for writing back on save (see
+    // LoadPlan::ExtraFields). Elements made by a split start without any
+    LoadPlan::ExtraFields extraFields() const noexcept { return extraFields_; }
+    void setExtraFields(LoadPlan::ExtraFields extraFields) noexcept { extraFields_ = extraFields; }
+
     void setRoleChoices(const QStringList& roles)
     {
         roleSelector_->clear();
@@ -55,6 +65,9 @@ signals:
     void roleChangeRequested(const QString& from, const QString& to);
     void roleAddRequested(const QString& role);
     void deleteRequested(Element*);
+    void speechChanged(Element*);
+    void roleChanged(Element*);
+    void eotChanged(Element*);
 
 protected:
     virtual bool eventFilter(QObject* watched, QEvent* event) override
@@ -75,6 +88,8 @@ protected:
     }
 
 private:
+    inline static qsizetype instances_ = 0;
+
     QHBoxLayout* mainLayout_ = nullptr;
     QVBoxLayout* controlLayout_ = nullptr;
     QHBoxLayout* topLayout_ = nullptr;
@@ -89,6 +104,7 @@ private:
     RoleSelector* roleSelector_ = new RoleSelector(this);
     AutoSizeTextEdit* speechEdit_ = new AutoSizeTextEdit(this);
     EotCheck* eotCheck_ = new EotCheck(this);
+    LoadPlan::ExtraFields extraFields_{};
 
     void initialize_();
 
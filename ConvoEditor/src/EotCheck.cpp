@@ -1,11 +1,11 @@
 #include <QCheckBox>
-#include <QDebug>
 #include <QHBoxLayout>
 #include <QWidget>
 
 #include "Coco/Layout.h"
 
 #include "EotCheck.h"
+#include "Logging.h"
 
 EotCheck::EotCheck(QWidget* parent)
     : QWidget(parent)
@@ -29,5 +29,5 @@ EotCheck::EotCheck(QWidget* parent)
 
 EotCheck::~EotCheck()
 {
-    qDebug() << __FUNCTION__;
+    qCDebug(lcLifetime) << __FUNCTION__;
 }
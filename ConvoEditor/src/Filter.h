@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+
+#include "LoadPlan.h"
+
+// A predicate over turn data (not widgets), so it can be evaluated on a
+// snapshot of the document, off the GUI thread. Empty criteria match
+// anything
+struct Filter
+{
+    enum class Eot
+    {
+        Any,
+        Checked,
+        Unchecked
+    };
+
+    QString role{};
+    Eot eot = Eot::Any;
+    bool emptyOnly = false;
+    QString text{};
+
+    bool isNull() const noexcept
+    {
+        return role.isEmpty()
+            && eot == Eot::Any
+            && !emptyOnly
+            && text.isEmpty();
+    }
+
+    bool matches(const LoadPlan::Item& item) const
+    {
+        if (!role.isEmpty() && item.role != role) return false;
+        if (eot == Eot::Checked && !item.eot) return false;
+        if (eot == Eot::Unchecked && item.eot) return false;
+        if (emptyOnly && !item.speech.trimmed().isEmpty()) return false;
+        if (!text.isEmpty() && !item.speech.contains(text, Qt::CaseInsensitive)) return false;
+
+        return true;
+    }
+};
@@ -0,0 +1,105 @@
+#include <QCheckBox>
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QSignalBlocker>
+#include <QStringList>
+#include <QToolButton>
+#include <QWidget>
+
+#include "Coco/Layout.h"
+
+#include "FilterBar.h"
+#include "Logging.h"
+
+FilterBar::FilterBar(QWidget* parent)
+    : QWidget(parent)
+{
+    initialize_();
+}
+
+FilterBar::~FilterBar()
+{
+    qCDebug(lcLifetime) << __FUNCTION__;
+}
+
+void FilterBar::setRoles(const QStringList& roles)
+{
+    // Keep the current selection if the role still exists
+    auto current = role_->currentText();
+
+    {
+        QSignalBlocker blocker(role_);
+
+        role_->clear();
+        role_->addItem("Any role");
+        role_->addItems(roles);
+
+        auto index = role_->findText(current);
+        role_->setCurrentIndex((index > 0) ? index : 0);
+    }
+
+    if (role_->currentText() != current)
+        emit filterChanged();
+}
+
+void FilterBar::initialize_()
+{
+    // Order matches Filter::Eot
+    eot_->addItems({ "Any EOT", "EOT", "No EOT" });
+    role_->addItem("Any role");
+    emptyOnly_->setText("Empty only");
+    text_->setPlaceholderText("Containing");
+    text_->setClearButtonEnabled(true);
+    close_->setText("x");
+
+    auto layout = Coco::Layout::zeroPadded<QHBoxLayout>(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->setSpacing(4);
+
+    layout->addWidget(role_, 0);
+    layout->addWidget(eot_, 0);
+    layout->addWidget(emptyOnly_, 0);
+    layout->addWidget(text_, 1);
+    layout->addWidget(close_, 0);
+
+    connect
+    (
+        role_,
+        &QComboBox::currentIndexChanged,
+        this,
+        &FilterBar::filterChanged
+    );
+
+    connect
+    (
+        eot_,
+        &QComboBox::currentIndexChanged,
+        this,
+        &FilterBar::filterChanged
+    );
+
+    connect
+    (
+        emptyOnly_,
+        &QCheckBox::toggled,
+        this,
+        &FilterBar::filterChanged
+    );
+
+    connect
+    (
+        text_,
+        &QLineEdit::textChanged,
+        this,
+        &FilterBar::filterChanged
+    );
+
+    connect
+    (
+        close_,
+        &QToolButton::clicked,
+        this,
+        [&] { dismiss_(); }
+    );
+}
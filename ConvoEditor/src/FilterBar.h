@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QObject>
+#include <QStringList>
+#include <QToolButton>
+#include <QWidget>
+
+#include "Filter.h"
+
+class FilterBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit FilterBar(QWidget* parent = nullptr);
+    virtual ~FilterBar() override;
+
+    // A hidden filter bar filters nothing
+    Filter filter() const
+    {
+        if (isHidden()) return {};
+
+        return
+        {
+            (role_->currentIndex() > 0) ? role_->currentText() : QString{},
+            static_cast<Filter::Eot>(eot_->currentIndex()),
+            emptyOnly_->isChecked(),
+            text_->text()
+        };
+    }
+
+    void setRoles(const QStringList& roles);
+
+    void activate()
+    {
+        show();
+        text_->setFocus();
+        emit filterChanged();
+    }
+
+signals:
+    void filterChanged();
+
+protected:
+    virtual void keyPressEvent(QKeyEvent* event) override
+    {
+        if (event->key() == Qt::Key_Escape)
+        {
+            dismiss_();
+            return;
+        }
+
+        QWidget::keyPressEvent(event);
+    }
+
+private:
+    QComboBox* role_ = new QComboBox(this);
+    QComboBox* eot_ = new QComboBox(this);
+    QCheckBox* emptyOnly_ = new QCheckBox(this);
+    QLineEdit* text_ = new QLineEdit(this);
+    QToolButton* close_ = new QToolButton(this);
+
+    void initialize_();
+
+    void dismiss_()
+    {
+        hide();
+        emit filterChanged();
+    }
+};
@@ -0,0 +1,109 @@
+#include <unordered_map>
+
+#include <QChar>
+#include <QFont>
+#include <QString>
+#include <QStringView>
+#include <QtMath>
+
+#include "HeightEstimator.h"
+
+HeightEstimator::HeightEstimator(const QFont& font)
+    : metrics_(font)
+{
+    lineSpacing_ = metrics_.lineSpacing();
+    spaceWidth_ = metrics_.horizontalAdvance(QChar(u' '));
+
+    for (auto i = 0; i < static_cast<int>(latin1Widths_.size()); ++i)
+        latin1Widths_[i] = static_cast<float>(metrics_.horizontalAdvance(QChar(i)));
+}
+
+HeightEstimator& HeightEstimator::forFont(const QFont& font)
+{
+    // Not QHash, which moves its entries when it grows: callers can hold
+    // on to the reference while another font's estimator is added
+    static std::unordered_map<QString, HeightEstimator> estimators{};
+
+    auto it = estimators.try_emplace(font.key(), font).first;
+    return it->second;
+}
+
+HeightEstimator::Words HeightEstimator::words(QStringView text) const
+{
+    Words words{};
+    auto width = 0.0f;
+    auto in_word = false;
+
+    for (auto& c : text)
+    {
+        if (c.isSpace())
+        {
+            if (in_word) words << width;
+            in_word = false;
+            width = 0.0f;
+
+            if (c == u'\n' || c == QChar::ParagraphSeparator)
+                words << PARAGRAPH_BREAK_;
+
+            continue;
+        }
+
+        in_word = true;
+        width += charWidth_(c);
+    }
+
+    if (in_word) words << width;
+    return words;
+}
+
+int HeightEstimator::lineCount(const Words& words, qreal width) const
+{
+    // Greedy, like QTextLayout: fill the line, wrap at word boundaries, and
+    // break words that don't fit on a line by themselves anywhere
+    if (width <= 0.0) width = 1.0;
+
+    auto lines = 1;
+    auto line_width = 0.0;
+
+    for (auto word : words)
+    {
+        if (word < 0.0f)
+        {
+            ++lines;
+            line_width = 0.0;
+            continue;
+        }
+
+        auto needed = line_width > 0.0 ? line_width + spaceWidth_ + word : word;
+
+        if (needed <= width)
+        {
+            line_width = needed;
+            continue;
+        }
+
+        if (line_width > 0.0) ++lines;
+
+        if (word > width)
+        {
+            auto extra = qCeil(word / width) - 1;
+            lines += extra;
+            line_width = word - (extra * width);
+        }
+        else
+        {
+            line_width = word;
+        }
+    }
+
+    return lines;
+}
+
+void HeightEstimator::correct(const Words& words, qreal width, qreal measuredHeight)
+{
+    auto predicted = lineCount(words, width) * lineSpacing_;
+    if (predicted <= 0.0 || measuredHeight <= 0.0) return;
+
+    auto ratio = qBound(0.5, measuredHeight / predicted, 2.0);
+    correction_ += (ratio - correction_) * CORRECTION_WEIGHT_;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+
+#include <QChar>
+#include <QFont>
+#include <QFontMetricsF>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+// Predicts how tall wrapped plain text will be without laying out a
+// QTextDocument. Text is boiled down to its word widths once (from a cached
+// per-font character width table), after which wrapping it at any width is
+// just a greedy pass over those. Real measurements are fed back in to
+// correct for whatever the simple wrap gets wrong (kerning, line breaking
+// rules, etc.)
+//
+// There's one per font (see forFont), and it's GUI thread only
+class HeightEstimator
+{
+public:
+    // Word widths, in order. Paragraph breaks are negative
+    using Words = QList<float>;
+
+    explicit HeightEstimator(const QFont& font = {});
+
+    static HeightEstimator& forFont(const QFont& font);
+
+    Words words(QStringView text) const;
+    int lineCount(const Words& words, qreal width) const;
+
+    // Corrected text height, without document margins
+    qreal height(const Words& words, qreal width) const
+    {
+        return lineCount(words, width) * lineSpacing_ * correction_;
+    }
+
+    void correct(const Words& words, qreal width, qreal measuredHeight);
+
+private:
+    static constexpr auto PARAGRAPH_BREAK_ = -1.0f;
+
+    // Each measurement moves the correction this far toward what it saw
+    static constexpr auto CORRECTION_WEIGHT_ = 0.125;
+
+    QFontMetricsF metrics_;
+    qreal lineSpacing_ = 0.0;
+    qreal spaceWidth_ = 0.0;
+    qreal correction_ = 1.0;
+
+    // Latin-1 up front, everything else as it's seen
+    std::array<float, 256> latin1Widths_{};
+    mutable QHash<char16_t, float> otherWidths_{};
+
+    float charWidth_(QChar c) const
+    {
+        auto unicode = c.unicode();
+        if (unicode < latin1Widths_.size()) return latin1Widths_[unicode];
+
+        auto it = otherWidths_.constFind(unicode);
+        if (it != otherWidths_.cend()) return *it;
+
+        auto width = static_cast<float>(metrics_.horizontalAdvance(c));
+        otherWidths_.insert(unicode, width);
+        return width;
+    }
+};
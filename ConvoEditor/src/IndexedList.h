@@ -0,0 +1,317 @@
+#pragma once
+
+#include <iterator>
+#include <utility>
+
+#include <QHash>
+#include <QList>
+#include <QtTypes>
+
+// An ordered list of unique values with O(log N) insertion, removal, lookup
+// by index, and (the reason this exists) index lookup by value. QList's
+// indexOf is a linear scan and its insert/removeAt shift everything after,
+// which gets noticeable with tens of thousands of elements
+//
+// Internally, this is an implicit treap (a randomized balanced tree keyed by
+// position) with parent pointers. A hash maps each value to its node, and
+// the node's rank is found by walking up to the root
+template <typename T>
+class IndexedList
+{
+private:
+    struct Node
+    {
+        T value;
+        quint32 priority = 0;
+        qsizetype size = 1;
+        Node* left = nullptr;
+        Node* right = nullptr;
+        Node* parent = nullptr;
+    };
+
+public:
+    class ConstIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = qsizetype;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() = default;
+        explicit ConstIterator(const Node* node) : node_(node) {}
+
+        const T& operator*() const { return node_->value; }
+        const T* operator->() const { return &node_->value; }
+        bool operator==(const ConstIterator& other) const { return node_ == other.node_; }
+        bool operator!=(const ConstIterator& other) const { return node_ != other.node_; }
+
+        ConstIterator& operator++()
+        {
+            node_ = next_(node_);
+            return *this;
+        }
+
+        ConstIterator operator++(int)
+        {
+            auto it = *this;
+            ++(*this);
+            return it;
+        }
+
+    private:
+        const Node* node_ = nullptr;
+    };
+
+    IndexedList() = default;
+    IndexedList(const IndexedList&) = delete;
+    IndexedList& operator=(const IndexedList&) = delete;
+
+    IndexedList(IndexedList&& other) noexcept
+    {
+        swap(other);
+    }
+
+    IndexedList& operator=(IndexedList&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            swap(other);
+        }
+
+        return *this;
+    }
+
+    ~IndexedList() { clear(); }
+
+    void swap(IndexedList& other) noexcept
+    {
+        std::swap(root_, other.root_);
+        std::swap(nodes_, other.nodes_);
+        std::swap(seed_, other.seed_);
+    }
+
+    qsizetype count() const noexcept { return size_(root_); }
+    qsizetype size() const noexcept { return count(); }
+    bool isEmpty() const noexcept { return !root_; }
+    bool contains(const T& value) const { return nodes_.contains(value); }
+
+    ConstIterator begin() const { return ConstIterator(leftmost_(root_)); }
+    ConstIterator end() const { return ConstIterator(); }
+
+    T at(qsizetype index) const
+    {
+        auto node = root_;
+
+        while (node)
+        {
+            auto left_size = size_(node->left);
+
+            if (index < left_size)
+            {
+                node = node->left;
+            }
+            else if (index == left_size)
+            {
+                return node->value;
+            }
+            else
+            {
+                index -= left_size + 1;
+                node = node->right;
+            }
+        }
+
+        return T{};
+    }
+
+    T first() const { return at(0); }
+    T last() const { return at(count() - 1); }
+
+    // Returns -1 if the value isn't in the list
+    qsizetype indexOf(const T& value) const
+    {
+        const Node* node = nodes_.value(value, nullptr);
+        if (!node) return -1;
+
+        auto rank = size_(node->left);
+
+        while (node->parent)
+        {
+            if (node == node->parent->right)
+                rank += size_(node->parent->left) + 1;
+
+            node = node->parent;
+        }
+
+        return rank;
+    }
+
+    // Values must be unique. Inserting a value already in the list does
+    // nothing
+    void insert(qsizetype index, const T& value)
+    {
+        if (nodes_.contains(value)) return;
+
+        auto node = new Node{ value, nextPriority_() };
+        nodes_.insert(value, node);
+
+        Node* before = nullptr;
+        Node* after = nullptr;
+        split_(root_, qBound(qsizetype(0), index, count()), before, after);
+        setRoot_(merge_(merge_(before, node), after));
+    }
+
+    void append(const T& value) { insert(count(), value); }
+
+    IndexedList& operator<<(const T& value)
+    {
+        append(value);
+        return *this;
+    }
+
+    void removeAt(qsizetype index)
+    {
+        if (index < 0 || index >= count()) return;
+
+        Node* before = nullptr;
+        Node* middle = nullptr;
+        Node* after = nullptr;
+        split_(root_, index, before, middle);
+        split_(middle, 1, middle, after);
+
+        nodes_.remove(middle->value);
+        delete middle;
+
+        setRoot_(merge_(before, after));
+    }
+
+    bool removeOne(const T& value)
+    {
+        auto index = indexOf(value);
+        if (index < 0) return false;
+
+        removeAt(index);
+        return true;
+    }
+
+    void clear()
+    {
+        for (auto node : std::as_const(nodes_))
+            delete node;
+
+        nodes_.clear();
+        root_ = nullptr;
+    }
+
+    QList<T> toList() const
+    {
+        QList<T> list{};
+        list.reserve(count());
+
+        for (auto& value : *this)
+            list << value;
+
+        return list;
+    }
+
+private:
+    Node* root_ = nullptr;
+    QHash<T, Node*> nodes_{};
+    quint32 seed_ = 0x9e3779b9;
+
+    static qsizetype size_(const Node* node) noexcept
+    {
+        return node ? node->size : 0;
+    }
+
+    static const Node* leftmost_(const Node* node) noexcept
+    {
+        if (!node) return nullptr;
+
+        while (node->left)
+            node = node->left;
+
+        return node;
+    }
+
+    // In-order successor (amortized O(1) over a full iteration)
+    static const Node* next_(const Node* node) noexcept
+    {
+        if (!node) return nullptr;
+        if (node->right) return leftmost_(node->right);
+
+        while (node->parent && node == node->parent->right)
+            node = node->parent;
+
+        return node->parent;
+    }
+
+    static void update_(Node* node) noexcept
+    {
+        node->size = 1 + size_(node->left) + size_(node->right);
+        if (node->left) node->left->parent = node;
+        if (node->right) node->right->parent = node;
+    }
+
+    void setRoot_(Node* node) noexcept
+    {
+        root_ = node;
+        if (root_) root_->parent = nullptr;
+    }
+
+    quint32 nextPriority_() noexcept
+    {
+        // Xorshift is plenty for keeping the tree balanced
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        return seed_;
+    }
+
+    // Puts the first `count` nodes of tree in before and the rest in after.
+    // The parents of the returned roots are fixed up by whoever attaches
+    // them (or by setRoot_)
+    static void split_(Node* tree, qsizetype count, Node*& before, Node*& after)
+    {
+        if (!tree)
+        {
+            before = after = nullptr;
+            return;
+        }
+
+        if (size_(tree->left) < count)
+        {
+            split_(tree->right, count - size_(tree->left) - 1, tree->right, after);
+            before = tree;
+        }
+        else
+        {
+            split_(tree->left, count, before, tree->left);
+            after = tree;
+        }
+
+        update_(tree);
+        if (before) before->parent = nullptr;
+        if (after) after->parent = nullptr;
+    }
+
+    static Node* merge_(Node* before, Node* after)
+    {
+        if (!before) return after;
+        if (!after) return before;
+
+        if (before->priority > after->priority)
+        {
+            before->right = merge_(before->right, after);
+            update_(before);
+            return before;
+        }
+
+        after->left = merge_(before, after->left);
+        update_(after);
+        return after;
+    }
+};
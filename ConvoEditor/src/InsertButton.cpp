@@ -1,6 +1,6 @@
 #include "InsertButton.h"
+#include "Logging.h"
 
-#include <QDebug>
 #include <QToolButton>
 #include <QWidget>
 
@@ -8,6 +8,8 @@ InsertButton::InsertButton(int position, QWidget* parent)
     : QToolButton(parent)
     , position_(position)
 {
+    ++instances_;
+
     connect
     (
         this,
@@ -19,5 +21,6 @@ InsertButton::InsertButton(int position, QWidget* parent)
 
 InsertButton::~InsertButton()
 {
-    qDebug() << __FUNCTION__;
+    --instances_;
+    qCDebug(lcLifetime) << __FUNCTION__;
 }
@@ -2,8 +2,11 @@
 
 #include <QObject>
 #include <QToolButton>
+#include <QtTypes>
 #include <QWidget>
 
+// The position is the element index a new element would be inserted at. View
+// keeps only one of these and moves it (and its position) with the pointer
 class InsertButton : public QToolButton
 {
     Q_OBJECT
@@ -12,6 +15,8 @@ public:
     explicit InsertButton(int position, QWidget* parent = nullptr);
     virtual ~InsertButton() override;
 
+    static qsizetype instances() noexcept { return instances_; }
+
     int position() const noexcept { return position_; }
     void setPosition(int position) { position_ = position; }
 
@@ -19,5 +24,7 @@ signals:
     void insertRequested(int position);
 
 private:
+    inline static qsizetype instances_ = 0;
+
     int position_;
 };
@@ -0,0 +1,467 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QChar>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QtTypes>
+
+#include "Coco/Utility.h"
+
+#include "Keys.h"
+#include "LoadPlan.h"
+#include "Simd.h"
+
+// A small, strict JSON reader for the one shape we load. Strings we keep
+// are decoded into the plan's arena as they're scanned; everything else is
+// skipped without being decoded at all
+class LoadPlanParser
+{
+public:
+    LoadPlanParser(QByteArrayView json, LoadPlan& plan)
+        : p_(json.data()), end_(json.data() + json.size()), plan_(plan)
+    {
+    }
+
+    bool parse()
+    {
+        // UTF-16 never takes more units than the UTF-8 it came from had
+        // bytes, and there can't be more turns than opening braces
+        // (Skipping a byte order mark, if there is one)
+        if (end_ - p_ >= 3 && matches_(QByteArrayView(p_, 3), "\xEF\xBB\xBF"))
+            p_ += 3;
+
+        auto size = static_cast<qsizetype>(end_ - p_);
+        plan_.text_.resize(size);
+        arena_ = plan_.text_.data();
+        plan_.records_.reserve(std::count(p_, end_, '{'));
+
+        auto found_results = false;
+
+        // Kept apart until the end, since the results' own come in between
+        QList<QByteArrayView> top_level_extras{};
+
+        auto ok = object_([&](QByteArrayView key)
+            {
+                if (!matches_(key, Keys::RESULTS_ARRAY))
+                    return extraField_(key, top_level_extras);
+
+                found_results = true;
+                return results_();
+            });
+
+        plan_.text_.truncate(used_);
+        plan_.topLevelExtraFields_ = { plan_.extraSpans_.count(), top_level_extras.count() };
+        plan_.extraSpans_ << top_level_extras;
+
+        skipSpace_();
+        return ok && found_results && p_ == end_;
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+    LoadPlan& plan_;
+    QChar* arena_ = nullptr;
+    qsizetype used_ = 0;
+
+    void skipSpace_()
+    {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t'))
+            ++p_;
+    }
+
+    static bool matches_(QByteArrayView bytes, const char* text)
+    {
+        auto length = static_cast<qsizetype>(std::strlen(text));
+        return bytes.size() == length && std::memcmp(bytes.data(), text, length) == 0;
+    }
+
+    bool consume_(char c)
+    {
+        skipSpace_();
+        if (p_ >= end_ || *p_ != c) return false;
+
+        ++p_;
+        return true;
+    }
+
+    bool peek_(char c)
+    {
+        skipSpace_();
+        return p_ < end_ && *p_ == c;
+    }
+
+    // Calls onMember(key) with the raw key bytes (escapes and all, which is
+    // fine for comparing against our keys) with p_ at the value
+    template <typename OnMemberT>
+    bool object_(OnMemberT onMember)
+    {
+        if (!consume_('{')) return false;
+        if (consume_('}')) return true;
+
+        do
+        {
+            skipSpace_();
+
+            QByteArrayView key{};
+            if (!rawString_(key)) return false;
+            if (!consume_(':')) return false;
+            if (!onMember(key)) return false;
+        }
+        while (consume_(','));
+
+        return consume_('}');
+    }
+
+    bool results_()
+    {
+        if (!consume_('[')) return false;
+        if (consume_(']')) return true;
+
+        do
+        {
+            // Entries that aren't objects are ignored, like before
+            if (!peek_('{'))
+            {
+                if (!skipValue_()) return false;
+                continue;
+            }
+
+            if (!turn_()) return false;
+        }
+        while (consume_(','));
+
+        return consume_(']');
+    }
+
+    // Skips the value, keeping the whole member ("key": value) as it was
+    bool extraField_(QByteArrayView key, QList<QByteArrayView>& spans)
+    {
+        // (The key's view starts just past its opening quote)
+        auto start = key.data() - 1;
+        if (!skipValue_()) return false;
+
+        spans << QByteArrayView(start, p_ - start);
+        return true;
+    }
+
+    bool turn_()
+    {
+        LoadPlan::Record record{};
+        record.extraFields.first = plan_.extraSpans_.count();
+        qsizetype role_offset = -1;
+        qsizetype role_length = 0;
+
+        auto ok = object_([&](QByteArrayView key)
+            {
+                skipSpace_();
+
+                if (matches_(key, Keys::ROLE))
+                {
+                    // Decoded into the arena for now, swapped for an index
+                    // into roleNames_ below. One that isn't a string is
+                    // kept as is, and the turn's role is empty (see
+                    // View::compile_)
+                    if (!peek_('"')) return extraField_(key, plan_.extraSpans_);
+
+                    auto offset = used_;
+                    if (!decodeString_()) return false;
+
+                    role_offset = offset;
+                    role_length = used_ - offset;
+                    return true;
+                }
+
+                if (matches_(key, Keys::SPEECH))
+                {
+                    if (!peek_('"')) return extraField_(key, plan_.extraSpans_);
+
+                    auto offset = used_;
+                    if (!decodeString_()) return false;
+                    ++LoadPlan::counters().textCopies;
+
+                    record.offset = offset;
+                    record.length = used_ - offset;
+                    return true;
+                }
+
+                if (matches_(key, Keys::EOT))
+                {
+                    // Anything but true is false (as with QJsonValue::toBool).
+                    // One that isn't a bool is kept as is, like Role
+                    record.eot = literal_("true");
+                    if (record.eot || literal_("false")) return true;
+
+                    return extraField_(key, plan_.extraSpans_);
+                }
+
+                return extraField_(key, plan_.extraSpans_);
+            });
+
+        if (!ok) return false;
+        record.extraFields.count = plan_.extraSpans_.count() - record.extraFields.first;
+
+        QStringView role = (role_offset < 0)
+            ? QStringView{}
+            : QStringView(arena_ + role_offset, role_length);
+
+        record.role = roleIndex_(role);
+
+        // Role text is only kept in roleNames_, so give back its space if
+        // it's at the end of the arena (it is, unless Role came first)
+        if (role_offset >= 0 && role_offset + role_length == used_)
+            used_ = role_offset;
+
+        plan_.records_ << record;
+        return true;
+    }
+
+    int roleIndex_(QStringView role)
+    {
+        for (auto i = 0; i < plan_.roleNames_.count(); ++i)
+            if (plan_.roleNames_.at(i) == role)
+                return i;
+
+        plan_.roleNames_ << role.toString();
+        return static_cast<int>(plan_.roleNames_.count() - 1);
+    }
+
+    bool literal_(const char* literal)
+    {
+        auto length = static_cast<qsizetype>(std::strlen(literal));
+        if (end_ - p_ < length || !matches_(QByteArrayView(p_, length), literal)) return false;
+
+        p_ += length;
+        return true;
+    }
+
+    // The bytes between the quotes, undecoded
+    bool rawString_(QByteArrayView& out)
+    {
+        if (p_ >= end_ || *p_ != '"') return false;
+        auto start = ++p_;
+
+        while (p_ < end_ && *p_ != '"')
+        {
+            if (*p_ == '\\') ++p_;
+            ++p_;
+        }
+
+        if (p_ >= end_) return false;
+
+        out = QByteArrayView(start, p_ - start);
+        ++p_;
+        return true;
+    }
+
+    bool skipValue_()
+    {
+        skipSpace_();
+        if (p_ >= end_) return false;
+
+        switch (*p_)
+        {
+        case '"':
+        {
+            QByteArrayView ignored{};
+            return rawString_(ignored);
+        }
+
+        case '{':
+            return object_([&](QByteArrayView) { return skipValue_(); });
+
+        case '[':
+        {
+            ++p_;
+            if (consume_(']')) return true;
+
+            do
+            {
+                if (!skipValue_()) return false;
+            }
+            while (consume_(','));
+
+            return consume_(']');
+        }
+
+        case 't': return literal_("true");
+        case 'f': return literal_("false");
+        case 'n': return literal_("null");
+
+        default:
+        {
+            // Number
+            auto start = p_;
+
+            while (p_ < end_
+                && (std::isdigit(static_cast<unsigned char>(*p_))
+                    || *p_ == '-' || *p_ == '+' || *p_ == '.' || *p_ == 'e' || *p_ == 'E'))
+                ++p_;
+
+            return p_ != start;
+        }
+        }
+    }
+
+    static int hexValue_(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool hex4_(char16_t& out)
+    {
+        if (end_ - p_ < 4) return false;
+        out = 0;
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            auto value = hexValue_(p_[i]);
+            if (value < 0) return false;
+            out = static_cast<char16_t>((out << 4) | value);
+        }
+
+        p_ += 4;
+        return true;
+    }
+
+    void put_(char16_t unit) { arena_[used_++] = QChar(unit); }
+
+    // Decodes a JSON string (UTF-8, with escapes) onto the end of the arena.
+    // Malformed UTF-8 becomes U+FFFD
+    bool decodeString_()
+    {
+        if (p_ >= end_ || *p_ != '"') return false;
+        ++p_;
+
+        while (p_ < end_)
+        {
+            // Plain ASCII (most of any transcript) is widened a block at a
+            // time, up to the next byte that needs a closer look. There's
+            // always room for it: no byte decodes to more than one unit
+            auto run = Simd::widenPlainAscii(p_, end_, reinterpret_cast<char16_t*>(arena_ + used_));
+            p_ += run;
+            used_ += run;
+            if (p_ >= end_) break;
+
+            auto c = static_cast<unsigned char>(*p_);
+
+            if (c == '"')
+            {
+                ++p_;
+                return true;
+            }
+
+            if (c == '\\')
+            {
+                if (++p_ >= end_) return false;
+                auto escape = *p_++;
+
+                switch (escape)
+                {
+                case '"': put_(u'"'); break;
+                case '\\': put_(u'\\'); break;
+                case '/': put_(u'/'); break;
+                case 'b': put_(u'\b'); break;
+                case 'f': put_(u'\f'); break;
+                case 'n': put_(u'\n'); break;
+                case 'r': put_(u'\r'); break;
+                case 't': put_(u'\t'); break;
+
+                case 'u':
+                {
+                    // Surrogate pairs come as two escapes, and each half
+                    // is one UTF-16 unit anyway
+                    char16_t unit = 0;
+                    if (!hex4_(unit)) return false;
+                    put_(unit);
+                    break;
+                }
+
+                default: return false;
+                }
+
+                continue;
+            }
+
+            decodeMultibyte_();
+        }
+
+        return false;
+    }
+
+    void decodeMultibyte_()
+    {
+        // 0x80 to 0xC1 and 0xF5 up never start a valid sequence
+        auto c = static_cast<unsigned char>(*p_);
+        auto length = (c >= 0xF0) ? ((c < 0xF5) ? 4 : 0) : (c >= 0xE0) ? 3 : (c >= 0xC2) ? 2 : 0;
+        auto invalid = length == 0 || end_ - p_ < length;
+
+        // Some leads narrow what the second byte can be, which rules out
+        // overlongs (E0, F0), surrogates (ED) and past U+10FFFF (F4)
+        if (!invalid)
+        {
+            auto second = static_cast<unsigned char>(p_[1]);
+
+            switch (c)
+            {
+            case 0xE0: invalid = second < 0xA0 || second > 0xBF; break;
+            case 0xED: invalid = second < 0x80 || second > 0x9F; break;
+            case 0xF0: invalid = second < 0x90 || second > 0xBF; break;
+            case 0xF4: invalid = second < 0x80 || second > 0x8F; break;
+            default: break;
+            }
+        }
+
+        char32_t code_point = (length == 4) ? (c & 0x07) : (length == 3) ? (c & 0x0F) : (c & 0x1F);
+
+        for (auto i = 1; !invalid && i < length; ++i)
+        {
+            auto continuation = static_cast<unsigned char>(p_[i]);
+            invalid = (continuation & 0xC0) != 0x80;
+            code_point = (code_point << 6) | (continuation & 0x3F);
+        }
+
+        if (invalid)
+        {
+            put_(QChar::ReplacementCharacter);
+            ++p_;
+            return;
+        }
+
+        if (code_point >= 0x10000)
+        {
+            put_(QChar::highSurrogate(code_point));
+            put_(QChar::lowSurrogate(code_point));
+        }
+        else
+        {
+            put_(static_cast<char16_t>(code_point));
+        }
+
+        p_ += length;
+    }
+};
+
+LoadPlan LoadPlan::fromJson(const QByteArray& json)
+{
+    LoadPlan plan{};
+    plan.source_ = json;
+    LoadPlanParser parser(plan.source_, plan);
+
+    if (!parser.parse())
+        return {};
+
+    plan.sortedRoles_ = plan.roleNames_;
+    Coco::Utility::sort(plan.sortedRoles_);
+
+    return plan;
+}
@@ -1,59 +1,129 @@
 #pragma once
 
-#include <QJsonObject>
-#include <QJsonValue>
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QList>
-#include <QObject>
-#include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QStringView>
+#include <QtTypes>
 
-#include "Coco/Utility.h"
-
-#include "Keys.h"
-
+// A parsed document, ready to populate the view from. Turn text is decoded
+// straight from the file's UTF-8 into one UTF-16 arena, and each turn is a
+// small record pointing into it, so parsing allocates a handful of times no
+// matter how many turns there are. The whole thing is freed in one go once
+// it's dropped
 class LoadPlan
 {
 public:
+    // Deep copies of turn text made by a load, for the benchmark (see
+    // Bench): decoding into the arena, item(), and going into an editor's
+    // document (View::populate_). The benchmark adds copies back out of the
+    // document for height estimates (AutoSizeTextEdit::Counters). A load
+    // should only ever decode and fill documents. GUI thread only
+    struct Counters
+    {
+        qint64 textCopies = 0;
+    };
+
+    static constexpr auto MAX_TEXT_COPIES_PER_TURN = 2;
+
+    static Counters& counters() noexcept
+    {
+        static Counters counters{};
+        return counters;
+    }
+
+    // Fields we don't use (timestamps, confidence, word lists, etc.) are
+    // kept as the file's own bytes, key and all, to be written back as they
+    // were. A turn (or the top level) refers to a run of them in
+    // extraSpans(). They point into source(), so whatever keeps them needs
+    // to keep that too
+    struct ExtraFields
+    {
+        qsizetype first = 0;
+        qsizetype count = 0;
+    };
+
+    // A single turn, owning its text (for inserting elements, snapshots,
+    // etc.)
     struct Item
     {
         QString role{};
         QString speech{};
         bool eot = true;
+        ExtraFields extraFields{};
     };
 
+    // Null if the JSON isn't in the expected shape (see Keys). The plan
+    // shares json rather than copying it
+    static LoadPlan fromJson(const QByteArray& json);
+
     bool isNull() const noexcept
     {
-        return items_.isEmpty();
+        return records_.isEmpty();
     }
 
-    void add(const QJsonValue& jsonValue)
-    {
-        auto object = jsonValue.toObject();
-        auto role = object[Keys::ROLE].toString();
+    qsizetype count() const noexcept { return records_.count(); }
 
-        Item item
-        {
-            role,
-            object[Keys::SPEECH].toString(),
-            object[Keys::EOT].toBool()
-        };
+    const QString& role(qsizetype index) const
+    {
+        return roleNames_.at(records_.at(index).role);
+    }
 
-        items_ << item;
-        roles_ << role; // Will not add duplicates
+    QStringView speech(qsizetype index) const
+    {
+        const auto& record = records_.at(index);
+        return QStringView(text_).mid(record.offset, record.length);
     }
 
-    const QList<Item>& items() const noexcept
+    // Shares the arena instead of copying out of it, so it's only good for
+    // as long as the plan is. For handing straight to something that makes
+    // its own copy anyway (like a text document), and nothing that keeps it
+    QString borrowSpeech(qsizetype index) const
     {
-        return items_;
+        auto view = speech(index);
+        return QString::fromRawData(view.data(), view.size());
     }
 
-    QStringList roles() const
+    bool eot(qsizetype index) const { return records_.at(index).eot; }
+
+    ExtraFields extraFields(qsizetype index) const { return records_.at(index).extraFields; }
+
+    Item item(qsizetype index) const
     {
-        return Coco::Utility::toList(roles_, Coco::Sort::Yes);
+        ++counters().textCopies;
+        return { role(index), speech(index).toString(), eot(index), extraFields(index) };
     }
 
+    const QByteArray& source() const noexcept { return source_; }
+    const QList<QByteArrayView>& extraSpans() const noexcept { return extraSpans_; }
+    ExtraFields topLevelExtraFields() const noexcept { return topLevelExtraFields_; }
+
+    // Sorted once, after parsing
+    const QStringList& roles() const noexcept { return sortedRoles_; }
+
 private:
-    QList<Item> items_{};
-    QSet<QString> roles_{};
+    struct Record
+    {
+        int role = 0;
+        qsizetype offset = 0;
+        qsizetype length = 0;
+        bool eot = false;
+        ExtraFields extraFields{};
+    };
+
+    QString text_{};
+    QList<Record> records_{};
+
+    QByteArray source_{};
+    QList<QByteArrayView> extraSpans_{};
+    ExtraFields topLevelExtraFields_{};
+
+    // In order of first appearance. There are only ever a few, so finding
+    // one is a linear scan
+    QStringList roleNames_{};
+    QStringList sortedRoles_{};
+
+    friend class LoadPlanParser;
 };
@@ -0,0 +1,7 @@
+#include <QLoggingCategory>
+#include <QtLogging>
+
+#include "Logging.h"
+
+Q_LOGGING_CATEGORY(lcLifetime, "convo.lifetime", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcIo, "convo.io", QtWarningMsg)
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <QLoggingCategory>
+
+// Categories are off below warnings by default. Turn them on at runtime
+// with QT_LOGGING_RULES, e.g. QT_LOGGING_RULES="convo.lifetime.debug=true".
+// qCDebug checks the category before formatting anything, and Release
+// builds define QT_NO_DEBUG_OUTPUT, which compiles qCDebug out altogether
+Q_DECLARE_LOGGING_CATEGORY(lcLifetime) // Widget construction/destruction
+Q_DECLARE_LOGGING_CATEGORY(lcIo) // Loading and saving
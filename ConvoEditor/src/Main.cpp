@@ -1,11 +1,79 @@
 #include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QList>
+#include <QString>
+#include <QStringList>
 
+#include "Bench.h"
 #include "MainWindow.h"
+#include "Trace.h"
 
 int main(int argc, char* argv[])
 {
     QApplication app(argc, argv);
+
+    // Benchmarking (no window). E.g.:
+    // QT_QPA_PLATFORM=offscreen ConvoEditor --bench --turns 1000,10000
+    // ConvoEditor --generate big.json --turns 100000 --roles 4
+    // ConvoEditor --kernels --out kernels.jsonl
+    QCommandLineParser parser{};
+    parser.addHelpOption();
+
+    QCommandLineOption bench("bench", "Run the benchmarks and exit.");
+    QCommandLineOption kernels("kernels", "Run the text kernel microbenchmarks and exit.");
+    QCommandLineOption latency("latency", "Run the typing and scrolling latency benchmarks and exit.");
+    QCommandLineOption generate("generate", "Write a synthetic transcript and exit.", "path");
+    QCommandLineOption turns("turns", "Turn count (comma separated for --bench).", "n", "1000");
+    QCommandLineOption roles("roles", "Role count.", "n", "2");
+    QCommandLineOption words("words", "Mean words per turn.", "n", "20");
+    QCommandLineOption distribution("distribution", "constant, uniform or lognormal.", "name", "lognormal");
+    QCommandLineOption seed("seed", "Random seed.", "n", "1");
+    QCommandLineOption out("out", "Benchmark output (JSON lines). Defaults to stdout.", "path");
+    QCommandLineOption trace("trace", "Write a Chrome trace on exit (needs CONVO_TRACE).", "path");
+
+    parser.addOptions({ bench, kernels, latency, generate, turns, roles, words, distribution, seed, out, trace });
+    parser.process(app);
+
+    auto finish = [&](int exitCode)
+        {
+            if (parser.isSet(trace))
+                Trace::dump(parser.value(trace));
+
+            return exitCode;
+        };
+
+    if (parser.isSet(kernels))
+        return finish(Bench::runKernels(parser.value(out)));
+
+    if (parser.isSet(bench) || parser.isSet(latency) || parser.isSet(generate))
+    {
+        Bench::Options options{};
+        options.roles = parser.value(roles).toInt();
+        options.meanWords = parser.value(words).toInt();
+        options.distribution = Bench::distribution(parser.value(distribution));
+        options.seed = parser.value(seed).toUInt();
+
+        QList<int> turn_counts{};
+
+        for (auto& count : parser.value(turns).split(',', Qt::SkipEmptyParts))
+            turn_counts << count.trimmed().toInt();
+
+        if (turn_counts.isEmpty()) turn_counts << options.turns;
+
+        if (parser.isSet(generate))
+        {
+            options.turns = turn_counts.first();
+            return Bench::generate(options, parser.value(generate)) ? 0 : 1;
+        }
+
+        if (parser.isSet(latency))
+            return finish(Bench::runLatency(turn_counts, options, parser.value(out)));
+
+        return finish(Bench::run(turn_counts, options, parser.value(out)));
+    }
+
     MainWindow main_window{};
     main_window.show();
-    return app.exec();
+    return finish(app.exec());
 }
@@ -80,12 +80,29 @@ void MainWindow::initialize_()
     save_->setText("Save");
     autoEot_->setText("Auto EOT");
     split_->setText("Split");
+    merge_->setText("Merge");
+    mergeAll_->setText("Merge All");
+    splitLong_->setText("Split Long");
+    find_->setText("Find");
+    replace_->setText("Replace");
+    filter_->setText("Filter");
+    stats_->setText("Stats");
+    hud_->setText("HUD");
+    hud_->setCheckable(true);
+    perfHud_->hide();
     //undo_->setText("Undo");
     //redo_->setText("Redo");
 
     save_->setEnabled(false);
     autoEot_->setEnabled(false);
     split_->setEnabled(false);
+    merge_->setEnabled(false);
+    mergeAll_->setEnabled(false);
+    splitLong_->setEnabled(false);
+    find_->setEnabled(false);
+    replace_->setEnabled(false);
+    filter_->setEnabled(false);
+    stats_->setEnabled(false);
     //undo_->setEnabled(false);
     //redo_->setEnabled(false);
 
@@ -93,6 +110,15 @@ void MainWindow::initialize_()
     status_bar->addWidget(save_);
     status_bar->addWidget(autoEot_);
     status_bar->addWidget(split_);
+    status_bar->addWidget(merge_);
+    status_bar->addWidget(mergeAll_);
+    status_bar->addWidget(splitLong_);
+    status_bar->addWidget(find_);
+    status_bar->addWidget(replace_);
+    status_bar->addWidget(filter_);
+    status_bar->addWidget(stats_);
+    status_bar->addWidget(hud_);
+    status_bar->addPermanentWidget(perfHud_);
     //status_bar->addWidget(undo_);
     //status_bar->addWidget(redo_);
     setStatusBar(status_bar);
@@ -121,6 +147,70 @@ void MainWindow::initialize_()
         [&] { view_->split(); }
     );
 
+    connect
+    (
+        merge_,
+        &QToolButton::clicked,
+        this,
+        [&] { view_->merge(); }
+    );
+
+    connect
+    (
+        mergeAll_,
+        &QToolButton::clicked,
+        this,
+        [&] { view_->mergeAll(); }
+    );
+
+    connect
+    (
+        splitLong_,
+        &QToolButton::clicked,
+        this,
+        [&] { view_->splitLongTurns(); }
+    );
+
+    connect
+    (
+        find_,
+        &QToolButton::clicked,
+        this,
+        [&] { view_->find(); }
+    );
+
+    connect
+    (
+        replace_,
+        &QToolButton::clicked,
+        this,
+        [&] { view_->findReplace(); }
+    );
+
+    connect
+    (
+        filter_,
+        &QToolButton::clicked,
+        this,
+        [&] { view_->filter(); }
+    );
+
+    connect
+    (
+        stats_,
+        &QToolButton::clicked,
+        this,
+        [&] { view_->showStats(); }
+    );
+
+    connect
+    (
+        hud_,
+        &QToolButton::toggled,
+        perfHud_,
+        &PerfHud::setVisible
+    );
+
     connect
     (
         view_,
@@ -133,6 +223,13 @@ void MainWindow::initialize_()
             save_->setEnabled(true);
             autoEot_->setEnabled(true);
             split_->setEnabled(true);
+            merge_->setEnabled(true);
+            mergeAll_->setEnabled(true);
+            splitLong_->setEnabled(true);
+            find_->setEnabled(true);
+            replace_->setEnabled(true);
+            filter_->setEnabled(true);
+            stats_->setEnabled(true);
         }
     );
 }
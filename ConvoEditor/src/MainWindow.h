@@ -7,6 +7,7 @@
 #include <QToolButton>
 #include <QWidget>
 
+#include "PerfHud.h"
 #include "View.h"
 
 class MainWindow : public QMainWindow
@@ -25,6 +26,15 @@ private:
     QToolButton* save_ = new QToolButton(this);
     QToolButton* autoEot_ = new QToolButton(this);
     QToolButton* split_ = new QToolButton(this);
+    QToolButton* merge_ = new QToolButton(this);
+    QToolButton* mergeAll_ = new QToolButton(this);
+    QToolButton* splitLong_ = new QToolButton(this);
+    QToolButton* find_ = new QToolButton(this);
+    QToolButton* replace_ = new QToolButton(this);
+    QToolButton* filter_ = new QToolButton(this);
+    QToolButton* stats_ = new QToolButton(this);
+    QToolButton* hud_ = new QToolButton(this);
+    PerfHud* perfHud_ = new PerfHud(view_, this);
 
     void initialize_();
 };
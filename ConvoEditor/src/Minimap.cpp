@@ -0,0 +1,125 @@
+#include <algorithm>
+
+#include <QColor>
+#include <QImage>
+#include <QList>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPalette>
+#include <QRect>
+#include <QWidget>
+
+#include "Logging.h"
+#include "Minimap.h"
+
+Minimap::Minimap(QWidget* parent)
+    : QWidget(parent)
+{
+    setFixedWidth(12);
+    setCursor(Qt::PointingHandCursor);
+}
+
+Minimap::~Minimap()
+{
+    qCDebug(lcLifetime) << __FUNCTION__;
+}
+
+void Minimap::setColors(const QList<QColor>& colors)
+{
+    colors_ = colors;
+    render_();
+}
+
+void Minimap::setTurns(const QList<int>& roleIndexes)
+{
+    roleIndexes_ = roleIndexes;
+    render_();
+}
+
+void Minimap::setTurn(int index, int roleIndex)
+{
+    if (index < 0 || index >= roleIndexes_.count()) return;
+    if (roleIndexes_.at(index) == roleIndex) return;
+
+    roleIndexes_[index] = roleIndex;
+    renderRows_(rowOf_(index), rowOf_(index + 1));
+}
+
+void Minimap::insertTurn(int index, int roleIndex)
+{
+    // Every row from here down now maps to a different turn
+    index = qBound(0, index, static_cast<int>(roleIndexes_.count()));
+    roleIndexes_.insert(index, roleIndex);
+    renderRows_(rowOf_(index), height());
+}
+
+void Minimap::removeTurn(int index)
+{
+    if (index < 0 || index >= roleIndexes_.count()) return;
+
+    roleIndexes_.removeAt(index);
+    renderRows_(rowOf_(index), height());
+}
+
+void Minimap::setVisibleTurns(int first, int last)
+{
+    if (first == firstVisible_ && last == lastVisible_) return;
+
+    firstVisible_ = first;
+    lastVisible_ = last;
+    update();
+}
+
+void Minimap::paintEvent(QPaintEvent* event)
+{
+    QWidget::paintEvent(event);
+
+    QPainter painter(this);
+    painter.drawImage(0, 0, image_);
+
+    // Outline what's currently in the scroll area's viewport
+    if (firstVisible_ < 0 || lastVisible_ < firstVisible_) return;
+
+    auto top = rowOf_(firstVisible_);
+    auto bottom = qMax(top + 2, rowOf_(lastVisible_ + 1));
+
+    painter.setPen(palette().color(QPalette::WindowText));
+    painter.setBrush(QColor(255, 255, 255, 60));
+    painter.drawRect(QRect(0, top, width() - 1, bottom - top - 1));
+}
+
+void Minimap::renderRows_(int from, int to)
+{
+    if (width() < 1 || height() < 1) return;
+
+    if (image_.size() != size())
+    {
+        image_ = QImage(size(), QImage::Format_RGB32);
+        from = 0;
+        to = height();
+    }
+
+    from = qBound(0, from, height());
+    to = qBound(from, to, height());
+
+    auto background = palette().color(QPalette::Window).rgb();
+
+    for (auto y = from; y < to; ++y)
+    {
+        auto turn = turnAt_(y);
+        auto rgb = background;
+
+        if (turn > -1)
+        {
+            auto role_index = roleIndexes_.at(turn);
+
+            if (role_index > -1 && role_index < colors_.count())
+                rgb = colors_.at(role_index).rgb();
+        }
+
+        auto line = reinterpret_cast<QRgb*>(image_.scanLine(y));
+        std::fill(line, line + width(), rgb);
+    }
+
+    update(0, from, width(), to - from);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QList>
+#include <QMouseEvent>
+#include <QObject>
+#include <QPaintEvent>
+#include <QtTypes>
+#include <QResizeEvent>
+#include <QWidget>
+
+// A thin overview of the whole document, one colored band per turn (by role).
+// It's drawn from turn data only (role indexes), into a cached image, and
+// edits only redraw the rows they affect
+class Minimap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Minimap(QWidget* parent = nullptr);
+    virtual ~Minimap() override;
+
+    void setColors(const QList<QColor>& colors);
+    void setTurns(const QList<int>& roleIndexes);
+    void setTurn(int index, int roleIndex);
+    void insertTurn(int index, int roleIndex);
+    void removeTurn(int index);
+    void setVisibleTurns(int first, int last);
+
+signals:
+    void turnClicked(int index);
+
+protected:
+    virtual void paintEvent(QPaintEvent* event) override;
+
+    virtual void resizeEvent(QResizeEvent* event) override
+    {
+        QWidget::resizeEvent(event);
+        render_();
+    }
+
+    virtual void mousePressEvent(QMouseEvent* event) override
+    {
+        if (event->button() != Qt::LeftButton) return;
+        emitTurnAt_(event->position().toPoint().y());
+    }
+
+    virtual void mouseMoveEvent(QMouseEvent* event) override
+    {
+        // Dragging scrubs through the document
+        if (!(event->buttons() & Qt::LeftButton)) return;
+        emitTurnAt_(event->position().toPoint().y());
+    }
+
+private:
+    QList<int> roleIndexes_{};
+    QList<QColor> colors_{};
+    QImage image_{};
+    int firstVisible_ = -1;
+    int lastVisible_ = -1;
+
+    // Row y shows turn (y * turns / height). A turn covers the rows from
+    // ceil(turn * height / turns) up to (not including) the next turn's
+    qsizetype turnAt_(int y) const
+    {
+        if (roleIndexes_.isEmpty() || height() < 1) return -1;
+        return qBound<qsizetype>(0, (qsizetype(y) * roleIndexes_.count()) / height(), roleIndexes_.count() - 1);
+    }
+
+    int rowOf_(qsizetype turn) const
+    {
+        if (roleIndexes_.isEmpty()) return 0;
+
+        auto rows = static_cast<qsizetype>(height());
+        auto count = roleIndexes_.count();
+        return static_cast<int>(((turn * rows) + count - 1) / count);
+    }
+
+    void emitTurnAt_(int y)
+    {
+        auto turn = turnAt_(y);
+        if (turn > -1) emit turnClicked(static_cast<int>(turn));
+    }
+
+    void render_() { renderRows_(0, height()); }
+    void renderRows_(int from, int to);
+};
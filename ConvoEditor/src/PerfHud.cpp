@@ -0,0 +1,111 @@
+#include <QApplication>
+#include <QLabel>
+#include <QLocale>
+#include <QString>
+#include <QTimer>
+#include <QtGlobal>
+#include <QtTypes>
+#include <QWidget>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#include <QFile>
+#include <QIODevice>
+#include <QList>
+#include <QByteArray>
+#endif
+
+#include "Element.h"
+#include "InsertButton.h"
+#include "Logging.h"
+#include "PerfHud.h"
+#include "View.h"
+
+PerfHud::PerfHud(View* view, QWidget* parent)
+    : QLabel(parent), view_(view)
+{
+    timer_->setInterval(INTERVAL_MS_);
+
+    connect
+    (
+        timer_,
+        &QTimer::timeout,
+        this,
+        &PerfHud::refresh
+    );
+}
+
+PerfHud::~PerfHud()
+{
+    qCDebug(lcLifetime) << __FUNCTION__;
+}
+
+void PerfHud::refresh()
+{
+    auto metrics = view_->metrics();
+    QLocale locale{};
+
+    auto ms = [](double value)
+        {
+            return value < 0.0 ? QString("-") : QString::number(value, 'f', 1);
+        };
+
+    // UTF-16 text plus a fixed cost per document
+    auto text_bytes = (metrics.textCharacters * 2) + (metrics.elements * DOCUMENT_OVERHEAD_);
+    auto rss = processRss_();
+
+    // allWidgets builds a list of every widget, so it's only redone every
+    // few refreshes (and refreshes only happen while shown)
+    if (widgets_ < 0 || ++refreshesSinceWidgets_ >= WIDGETS_EVERY_)
+    {
+        widgets_ = QApplication::allWidgets().count();
+        refreshesSinceWidgets_ = 0;
+    }
+
+    setText
+    (
+        QString("Elements %1 (%2 shown, %3 live) | Insert buttons %4 | Widgets %5 | Text ~%6 | RSS %7 | Load %8 ms, Save %9 ms, Split %10 ms")
+            .arg(locale.toString(metrics.elements))
+            .arg(locale.toString(metrics.shown))
+            .arg(locale.toString(Element::instances()))
+            .arg(locale.toString(InsertButton::instances()))
+            .arg(locale.toString(widgets_))
+            .arg(locale.formattedDataSize(text_bytes))
+            .arg(rss < 0 ? QString("?") : locale.formattedDataSize(rss))
+            .arg(ms(metrics.lastLoadMs))
+            .arg(ms(metrics.lastSaveMs))
+            .arg(ms(metrics.lastSplitMs))
+    );
+}
+
+qint64 PerfHud::processRss_()
+{
+#if defined(Q_OS_WIN)
+
+    PROCESS_MEMORY_COUNTERS counters{};
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<qint64>(counters.WorkingSetSize);
+
+    return -1;
+
+#elif defined(Q_OS_LINUX)
+
+    // Second field is resident pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) return -1;
+
+    auto fields = statm.readAll().split(' ');
+    if (fields.count() < 2) return -1;
+
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+
+#else
+
+    return -1;
+
+#endif
+}
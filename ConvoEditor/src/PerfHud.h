@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QHideEvent>
+#include <QLabel>
+#include <QObject>
+#include <QShowEvent>
+#include <QTimer>
+#include <QtTypes>
+#include <QWidget>
+
+class View;
+
+// A status bar section with live element and widget counts, approximate text memory,
+// process RSS and the view's last load/save/split times. Only polls (once
+// a second) while shown
+class PerfHud : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit PerfHud(View* view, QWidget* parent = nullptr);
+    virtual ~PerfHud() override;
+
+    void refresh();
+
+protected:
+    virtual void showEvent(QShowEvent* event) override
+    {
+        QLabel::showEvent(event);
+        refresh();
+        timer_->start();
+    }
+
+    virtual void hideEvent(QHideEvent* event) override
+    {
+        QLabel::hideEvent(event);
+        timer_->stop();
+    }
+
+private:
+    static constexpr auto INTERVAL_MS_ = 1000;
+
+    // Rough per-document cost on top of the text (the document, its layout
+    // and a block), for the memory estimate
+    static constexpr auto DOCUMENT_OVERHEAD_ = 2048;
+
+    // Refreshes between widget counts (see refresh)
+    static constexpr auto WIDGETS_EVERY_ = 5;
+
+    View* view_;
+    QTimer* timer_ = new QTimer(this);
+    qsizetype widgets_ = -1;
+    int refreshesSinceWidgets_ = 0;
+
+    static qint64 processRss_();
+};
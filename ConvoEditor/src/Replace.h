@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QRegularExpressionMatchIterator>
+#include <QString>
+
+// Find-and-replace over element speech. These only touch strings, so they
+// can run off the GUI thread, on a snapshot of the document
+namespace Replace
+{
+    struct Options
+    {
+        QString find{};
+        QString replacement{};
+        bool regex = false;
+        bool matchCase = false;
+    };
+
+    struct Result
+    {
+        int matches = 0;
+        QString speech{};
+    };
+
+    inline Qt::CaseSensitivity caseSensitivity(const Options& options) noexcept
+    {
+        return options.matchCase ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    }
+
+    // Only used in regex mode (literal mode uses QString's own find and
+    // replace, so backslashes in the replacement aren't taken as
+    // backreferences), but always valid to call
+    inline QRegularExpression toRegex(const Options& options)
+    {
+        auto pattern_options = QRegularExpression::UseUnicodePropertiesOption;
+
+        if (!options.matchCase)
+            pattern_options |= QRegularExpression::CaseInsensitiveOption;
+
+        QRegularExpression regex
+        (
+            options.regex ? options.find : QRegularExpression::escape(options.find),
+            pattern_options
+        );
+
+        regex.optimize();
+        return regex;
+    }
+
+    inline int count(const QString& speech, const Options& options, const QRegularExpression& regex)
+    {
+        if (options.find.isEmpty()) return 0;
+
+        if (!options.regex)
+            return static_cast<int>(speech.count(options.find, caseSensitivity(options)));
+
+        auto matches = 0;
+        auto it = regex.globalMatch(speech);
+
+        while (it.hasNext())
+        {
+            it.next();
+            ++matches;
+        }
+
+        return matches;
+    }
+
+    // Leaves the result's speech null if nothing matched
+    inline Result apply(const QString& speech, const Options& options, const QRegularExpression& regex)
+    {
+        Result result{ count(speech, options, regex) };
+        if (result.matches < 1) return result;
+
+        result.speech = speech;
+
+        if (options.regex)
+            result.speech.replace(regex, options.replacement);
+        else
+            result.speech.replace(options.find, options.replacement, caseSensitivity(options));
+
+        return result;
+    }
+}
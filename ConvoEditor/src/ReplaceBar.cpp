@@ -0,0 +1,107 @@
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QToolButton>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include "Coco/Layout.h"
+
+#include "Logging.h"
+#include "ReplaceBar.h"
+
+ReplaceBar::ReplaceBar(QWidget* parent)
+    : QWidget(parent)
+{
+    initialize_();
+}
+
+ReplaceBar::~ReplaceBar()
+{
+    qCDebug(lcLifetime) << __FUNCTION__;
+}
+
+void ReplaceBar::initialize_()
+{
+    find_->setPlaceholderText("Find");
+    replacement_->setPlaceholderText("Replace with");
+    regex_->setText("Regex");
+    matchCase_->setText("Match case");
+    replaceAll_->setText("Replace all");
+    undo_->setText("Undo");
+    close_->setText("x");
+
+    undo_->setEnabled(false);
+
+    auto layout = Coco::Layout::zeroPadded<QVBoxLayout>(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->setSpacing(4);
+
+    auto top_layout = Coco::Layout::zeroPadded<QHBoxLayout>();
+    auto bottom_layout = Coco::Layout::zeroPadded<QHBoxLayout>();
+    top_layout->setSpacing(4);
+    bottom_layout->setSpacing(4);
+
+    top_layout->addWidget(find_, 1);
+    top_layout->addWidget(regex_, 0);
+    top_layout->addWidget(matchCase_, 0);
+    top_layout->addWidget(close_, 0);
+
+    bottom_layout->addWidget(replacement_, 1);
+    bottom_layout->addWidget(preview_, 0);
+    bottom_layout->addWidget(replaceAll_, 0);
+    bottom_layout->addWidget(undo_, 0);
+
+    layout->addLayout(top_layout);
+    layout->addLayout(bottom_layout);
+
+    // Only the find options affect the preview
+    connect
+    (
+        find_,
+        &QLineEdit::textChanged,
+        this,
+        &ReplaceBar::optionsChanged
+    );
+
+    connect
+    (
+        regex_,
+        &QCheckBox::toggled,
+        this,
+        &ReplaceBar::optionsChanged
+    );
+
+    connect
+    (
+        matchCase_,
+        &QCheckBox::toggled,
+        this,
+        &ReplaceBar::optionsChanged
+    );
+
+    connect
+    (
+        replaceAll_,
+        &QToolButton::clicked,
+        this,
+        &ReplaceBar::replaceAllRequested
+    );
+
+    connect
+    (
+        undo_,
+        &QToolButton::clicked,
+        this,
+        &ReplaceBar::undoRequested
+    );
+
+    connect
+    (
+        close_,
+        &QToolButton::clicked,
+        this,
+        [&] { dismiss_(); }
+    );
+}
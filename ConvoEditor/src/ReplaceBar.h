@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QCheckBox>
+#include <QKeyEvent>
+#include <QLabel>
+#include <QLineEdit>
+#include <QObject>
+#include <QString>
+#include <QToolButton>
+#include <QWidget>
+
+#include "Replace.h"
+
+class ReplaceBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ReplaceBar(QWidget* parent = nullptr);
+    virtual ~ReplaceBar() override;
+
+    Replace::Options options() const
+    {
+        return
+        {
+            find_->text(),
+            replacement_->text(),
+            regex_->isChecked(),
+            matchCase_->isChecked()
+        };
+    }
+
+    void activate()
+    {
+        show();
+        find_->setFocus();
+        find_->selectAll();
+        emit optionsChanged();
+    }
+
+    void setPreview(const QString& text) { preview_->setText(text); }
+    void setUndoEnabled(bool enabled) { undo_->setEnabled(enabled); }
+
+signals:
+    void optionsChanged();
+    void replaceAllRequested();
+    void undoRequested();
+    void closed();
+
+protected:
+    virtual void keyPressEvent(QKeyEvent* event) override
+    {
+        if (event->key() == Qt::Key_Escape)
+        {
+            dismiss_();
+            return;
+        }
+
+        QWidget::keyPressEvent(event);
+    }
+
+private:
+    QLineEdit* find_ = new QLineEdit(this);
+    QLineEdit* replacement_ = new QLineEdit(this);
+    QCheckBox* regex_ = new QCheckBox(this);
+    QCheckBox* matchCase_ = new QCheckBox(this);
+    QLabel* preview_ = new QLabel(this);
+    QToolButton* replaceAll_ = new QToolButton(this);
+    QToolButton* undo_ = new QToolButton(this);
+    QToolButton* close_ = new QToolButton(this);
+
+    void initialize_();
+
+    void dismiss_()
+    {
+        hide();
+        emit closed();
+    }
+};
@@ -1,5 +1,4 @@
 #include <QComboBox>
-#include <QDebug>
 #include <QPainter>
 #include <QPaintEvent>
 #include <QString>
@@ -8,6 +7,7 @@
 #include <QStylePainter>
 #include <QWidget>
 
+#include "Logging.h"
 #include "RoleSelector.h"
 
 RoleSelector::RoleSelector(QWidget* parent)
@@ -17,7 +17,7 @@ RoleSelector::RoleSelector(QWidget* parent)
 
 RoleSelector::~RoleSelector()
 {
-    qDebug() << __FUNCTION__;
+    qCDebug(lcLifetime) << __FUNCTION__;
 }
 
 void RoleSelector::paintEvent(QPaintEvent* event)
@@ -0,0 +1,103 @@
+#include <QHash>
+#include <QString>
+#include <QStringView>
+
+#include "RoleStats.h"
+#include "Simd.h"
+
+void RoleStats::set(Key key, const QString& role, const QString& speech, bool eot)
+{
+    remove(key);
+
+    Entry entry{ role, countWords(speech), speech.length(), eot };
+    add_(entry);
+    entries_.insert(key, entry);
+}
+
+void RoleStats::setRole(Key key, const QString& role)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->role == role) return;
+
+    subtract_(*it);
+    it->role = role;
+    add_(*it);
+}
+
+void RoleStats::setSpeech(Key key, const QString& speech)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+
+    auto words = countWords(speech);
+    auto characters = speech.length();
+    if (it->words == words && it->characters == characters) return;
+
+    subtract_(*it);
+    it->words = words;
+    it->characters = characters;
+    add_(*it);
+}
+
+void RoleStats::setEot(Key key, bool eot)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->eot == eot) return;
+
+    subtract_(*it);
+    it->eot = eot;
+    add_(*it);
+}
+
+void RoleStats::remove(Key key)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+
+    subtract_(*it);
+    entries_.erase(it);
+}
+
+qsizetype RoleStats::countWords(const QString& speech)
+{
+    QStringView view(speech);
+    qsizetype words = 0;
+
+    for (auto i = Simd::skipSpace(view); i < view.size(); i = Simd::skipSpace(view, Simd::findSpace(view, i)))
+        ++words;
+
+    return words;
+}
+
+void RoleStats::add_(const Entry& entry)
+{
+    for (auto totals : { &roles_[entry.role], &total_ })
+    {
+        ++totals->turns;
+        totals->words += entry.words;
+        totals->characters += entry.characters;
+        if (entry.eot) ++totals->eotTurns;
+    }
+}
+
+void RoleStats::subtract_(const Entry& entry)
+{
+    auto it = roles_.find(entry.role);
+
+    if (it != roles_.end())
+    {
+        --it->turns;
+        it->words -= entry.words;
+        it->characters -= entry.characters;
+        if (entry.eot) --it->eotTurns;
+
+        // Roles pass through placeholder values while an element's role
+        // choices are reset, so don't let those pile up
+        if (it->turns < 1) roles_.erase(it);
+    }
+
+    --total_.turns;
+    total_.words -= entry.words;
+    total_.characters -= entry.characters;
+    if (entry.eot) --total_.eotTurns;
+}
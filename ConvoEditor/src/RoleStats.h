@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QtTypes>
+
+class Element;
+
+// Per-role aggregates, kept up to date one element at a time. Each element's
+// last contribution is remembered, so an edit only subtracts the old one and
+// adds the new one, no matter how big the document is
+class RoleStats
+{
+public:
+    using Key = const Element*;
+
+    struct Totals
+    {
+        qsizetype turns = 0;
+        qsizetype words = 0;
+        qsizetype characters = 0;
+        qsizetype eotTurns = 0;
+
+        double averageWords() const noexcept
+        {
+            return turns ? static_cast<double>(words) / turns : 0.0;
+        }
+
+        double eotShare() const noexcept
+        {
+            return turns ? static_cast<double>(eotTurns) / turns : 0.0;
+        }
+    };
+
+    void clear()
+    {
+        entries_.clear();
+        roles_.clear();
+        total_ = {};
+    }
+
+    Totals role(const QString& role) const { return roles_.value(role); }
+    const Totals& total() const noexcept { return total_; }
+
+    void set(Key key, const QString& role, const QString& speech, bool eot);
+    void setRole(Key key, const QString& role);
+    void setSpeech(Key key, const QString& speech);
+    void setEot(Key key, bool eot);
+    void remove(Key key);
+
+    static qsizetype countWords(const QString& speech);
+
+private:
+    struct Entry
+    {
+        QString role{};
+        qsizetype words = 0;
+        qsizetype characters = 0;
+        bool eot = false;
+    };
+
+    QHash<Key, Entry> entries_{};
+    QHash<QString, Totals> roles_{};
+    Totals total_{};
+
+    void add_(const Entry& entry);
+    void subtract_(const Entry& entry);
+};
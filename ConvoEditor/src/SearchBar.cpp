@@ -0,0 +1,88 @@
+#include <QApplication>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QToolButton>
+#include <QWidget>
+
+#include "Coco/Layout.h"
+
+#include "Logging.h"
+#include "SearchBar.h"
+
+SearchBar::SearchBar(QWidget* parent)
+    : QWidget(parent)
+{
+    initialize_();
+}
+
+SearchBar::~SearchBar()
+{
+    qCDebug(lcLifetime) << __FUNCTION__;
+}
+
+void SearchBar::initialize_()
+{
+    lineEdit_->setPlaceholderText("Find");
+    lineEdit_->setClearButtonEnabled(true);
+    previous_->setText("<");
+    next_->setText(">");
+    close_->setText("x");
+
+    auto layout = Coco::Layout::zeroPadded<QHBoxLayout>(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->setSpacing(4);
+
+    layout->addWidget(lineEdit_, 1);
+    layout->addWidget(result_, 0);
+    layout->addWidget(previous_, 0);
+    layout->addWidget(next_, 0);
+    layout->addWidget(close_, 0);
+
+    connect
+    (
+        lineEdit_,
+        &QLineEdit::textChanged,
+        this,
+        &SearchBar::queryChanged
+    );
+
+    // Enter goes to the next hit (Shift + Enter, the previous)
+    connect
+    (
+        lineEdit_,
+        &QLineEdit::returnPressed,
+        this,
+        [&]
+        {
+            if (QApplication::keyboardModifiers() & Qt::ShiftModifier)
+                emit previousRequested();
+            else
+                emit nextRequested();
+        }
+    );
+
+    connect
+    (
+        previous_,
+        &QToolButton::clicked,
+        this,
+        &SearchBar::previousRequested
+    );
+
+    connect
+    (
+        next_,
+        &QToolButton::clicked,
+        this,
+        &SearchBar::nextRequested
+    );
+
+    connect
+    (
+        close_,
+        &QToolButton::clicked,
+        this,
+        [&] { dismiss_(); }
+    );
+}
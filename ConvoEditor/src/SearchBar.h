@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QKeyEvent>
+#include <QLabel>
+#include <QLineEdit>
+#include <QObject>
+#include <QString>
+#include <QToolButton>
+#include <QWidget>
+
+class SearchBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SearchBar(QWidget* parent = nullptr);
+    virtual ~SearchBar() override;
+
+    QString query() const { return lineEdit_->text(); }
+
+    void activate()
+    {
+        show();
+        lineEdit_->setFocus();
+        lineEdit_->selectAll();
+    }
+
+    // Current is 0-based. Pass total 0 for no hits
+    void setResult(int current, int total)
+    {
+        if (query().isEmpty())
+            result_->clear();
+        else if (total < 1)
+            result_->setText("No results");
+        else
+            result_->setText(QString("%1 of %2").arg(current + 1).arg(total));
+    }
+
+signals:
+    void queryChanged(const QString& query);
+    void nextRequested();
+    void previousRequested();
+    void closed();
+
+protected:
+    virtual void keyPressEvent(QKeyEvent* event) override
+    {
+        if (event->key() == Qt::Key_Escape)
+        {
+            dismiss_();
+            return;
+        }
+
+        QWidget::keyPressEvent(event);
+    }
+
+private:
+    QLineEdit* lineEdit_ = new QLineEdit(this);
+    QLabel* result_ = new QLabel(this);
+    QToolButton* previous_ = new QToolButton(this);
+    QToolButton* next_ = new QToolButton(this);
+    QToolButton* close_ = new QToolButton(this);
+
+    void initialize_();
+
+    void dismiss_()
+    {
+        hide();
+        emit closed();
+    }
+};
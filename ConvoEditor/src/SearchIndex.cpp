@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <QChar>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+#include "SearchIndex.h"
+
+void SearchIndex::set(Key key, QStringView role, QStringView speech)
+{
+    remove(key);
+
+    QHash<QString, int> frequencies{};
+
+    for (auto& term : tokenize(role))
+        ++frequencies[term];
+
+    for (auto& term : tokenize(speech))
+        ++frequencies[term];
+
+    QStringList terms{};
+    terms.reserve(frequencies.count());
+
+    for (auto it = frequencies.cbegin(); it != frequencies.cend(); ++it)
+    {
+        postings_[it.key()].insert(key, it.value());
+        terms << it.key();
+    }
+
+    terms_.insert(key, terms);
+}
+
+void SearchIndex::remove(Key key)
+{
+    auto it = terms_.find(key);
+    if (it == terms_.end()) return;
+
+    for (auto& term : *it)
+    {
+        auto posting = postings_.find(term);
+        if (posting == postings_.end()) continue;
+
+        posting->remove(key);
+        if (posting->isEmpty()) postings_.erase(posting);
+    }
+
+    terms_.erase(it);
+}
+
+QList<SearchIndex::Hit> SearchIndex::search(const QString& query) const
+{
+    auto words = tokenize(query);
+    if (words.isEmpty() || terms_.isEmpty()) return {};
+
+    auto total = static_cast<double>(terms_.count());
+
+    auto idf = [total](qsizetype documentFrequency)
+        {
+            return std::log(1.0 + (total / static_cast<double>(documentFrequency)));
+        };
+
+    // Scores for keys that have matched every word so far
+    QHash<Key, double> scores{};
+
+    for (auto i = 0; i < words.count(); ++i)
+    {
+        const auto& word = words.at(i);
+        auto is_prefix = (i == words.count() - 1);
+
+        QHash<Key, double> word_scores{};
+
+        auto add_posting = [&](const QHash<Key, int>& posting)
+            {
+                auto weight = idf(posting.count());
+
+                for (auto it = posting.cbegin(); it != posting.cend(); ++it)
+                    word_scores[it.key()] += (1.0 + std::log(it.value())) * weight;
+            };
+
+        if (is_prefix)
+        {
+            for (auto it = postings_.lowerBound(word);
+                it != postings_.cend() && it.key().startsWith(word);
+                ++it)
+                add_posting(it.value());
+        }
+        else
+        {
+            auto it = postings_.constFind(word);
+            if (it == postings_.cend()) return {};
+            add_posting(it.value());
+        }
+
+        if (i == 0)
+        {
+            scores = std::move(word_scores);
+            continue;
+        }
+
+        // Intersect
+        for (auto it = scores.begin(); it != scores.end();)
+        {
+            auto match = word_scores.constFind(it.key());
+
+            if (match == word_scores.cend())
+            {
+                it = scores.erase(it);
+            }
+            else
+            {
+                it.value() += match.value();
+                ++it;
+            }
+        }
+
+        if (scores.isEmpty()) return {};
+    }
+
+    QList<Hit> hits{};
+    hits.reserve(scores.count());
+
+    for (auto it = scores.cbegin(); it != scores.cend(); ++it)
+        hits << Hit{ it.key(), it.value() };
+
+    std::sort
+    (
+        hits.begin(),
+        hits.end(),
+        [](const Hit& a, const Hit& b) { return a.score > b.score; }
+    );
+
+    return hits;
+}
+
+QStringList SearchIndex::tokenize(QStringView text)
+{
+    // Words are runs of letters and numbers. Apostrophes inside a word are
+    // kept (so "don't" is one word)
+    QStringList tokens{};
+    QString token{};
+
+    for (auto i = 0; i < text.length(); ++i)
+    {
+        auto c = text.at(i);
+
+        auto is_inner_apostrophe = (c == '\'')
+            && !token.isEmpty()
+            && (i + 1 < text.length())
+            && text.at(i + 1).isLetterOrNumber();
+
+        if (c.isLetterOrNumber() || is_inner_apostrophe)
+        {
+            token += c.toLower();
+            continue;
+        }
+
+        if (!token.isEmpty())
+        {
+            tokens << token;
+            token.clear();
+        }
+    }
+
+    if (!token.isEmpty())
+        tokens << token;
+
+    return tokens;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QtTypes>
+
+class Element;
+
+// An inverted index over element text and roles. It never dereferences its
+// keys, so it can be built off the GUI thread from a snapshot of element
+// data and handed back afterward
+//
+// Queries match whole words, except the last word in a query, which matches
+// as a prefix (so results show up while the user is still typing). Every
+// query word must match. Hits are ranked by TF-IDF
+class SearchIndex
+{
+public:
+    using Key = const Element*;
+
+    struct Hit
+    {
+        Key key = nullptr;
+        double score = 0.0;
+    };
+
+    qsizetype count() const noexcept { return terms_.count(); }
+    bool contains(Key key) const { return terms_.contains(key); }
+
+    void clear()
+    {
+        postings_.clear();
+        terms_.clear();
+    }
+
+    void set(Key key, QStringView role, QStringView speech);
+    void remove(Key key);
+    QList<Hit> search(const QString& query) const;
+
+    static QStringList tokenize(QStringView text);
+
+private:
+    // Term -> (key -> term frequency). A map, so prefixes are a range
+    QMap<QString, QHash<Key, int>> postings_{};
+
+    // Key -> its distinct terms (so it can be removed from postings_)
+    QHash<Key, QStringList> terms_{};
+};
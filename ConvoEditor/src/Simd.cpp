@@ -0,0 +1,276 @@
+#include <bit>
+#include <cstddef>
+
+#include <QChar>
+#include <QStringView>
+#include <QtTypes>
+
+#include "Simd.h"
+#include "SimdAvx2.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIMD_SSE2_
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+namespace Simd
+{
+    namespace
+    {
+        // Each set of kernels answers the ASCII questions for a whole run of
+        // text; what's left goes to QChar (see findSpace). maybeSpace finds
+        // the first unit that's ASCII whitespace or not ASCII at all, and
+        // maybeNotSpace the first that isn't ASCII whitespace. Sizes are
+        // ptrdiff_t rather than qsizetype to match SimdAvx2, which can't
+        // include Qt (and qsizetype isn't ptrdiff_t everywhere)
+        struct Kernels
+        {
+            const char* name;
+            std::ptrdiff_t (*maybeSpace)(const char16_t* units, std::ptrdiff_t size);
+            std::ptrdiff_t (*maybeNotSpace)(const char16_t* units, std::ptrdiff_t size);
+            std::ptrdiff_t (*widenPlainAscii)(const char* begin, const char* end, char16_t* out);
+        };
+
+        bool isAsciiSpace_(char16_t c) noexcept
+        {
+            return c == u' ' || (c >= u'\t' && c <= u'\r');
+        }
+
+        bool isPlainAscii_(char c) noexcept
+        {
+            return static_cast<unsigned char>(c) < 0x80 && c != '"' && c != '\\';
+        }
+
+        std::ptrdiff_t scalarMaybeSpace_(const char16_t* units, std::ptrdiff_t size)
+        {
+            for (std::ptrdiff_t i = 0; i < size; ++i)
+                if (units[i] >= 0x80 || isAsciiSpace_(units[i]))
+                    return i;
+
+            return size;
+        }
+
+        std::ptrdiff_t scalarMaybeNotSpace_(const char16_t* units, std::ptrdiff_t size)
+        {
+            for (std::ptrdiff_t i = 0; i < size; ++i)
+                if (!isAsciiSpace_(units[i]))
+                    return i;
+
+            return size;
+        }
+
+        std::ptrdiff_t scalarWidenPlainAscii_(const char* begin, const char* end, char16_t* out)
+        {
+            auto p = begin;
+
+            for (; p < end && isPlainAscii_(*p); ++p)
+                out[p - begin] = static_cast<unsigned char>(*p);
+
+            return p - begin;
+        }
+
+#if defined(SIMD_SSE2_)
+
+        // UTF-16 units per block
+        constexpr std::ptrdiff_t BLOCK_ = 8;
+
+        __m128i load_(const char16_t* p)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        // Lanes that are \t to \r (9 to 13) or a space. Subtracting 9 puts
+        // the control range at 0 to 4, and anything else saturates past 4
+        __m128i asciiSpaceLanes_(__m128i units)
+        {
+            auto shifted = _mm_sub_epi16(units, _mm_set1_epi16(9));
+            auto control = _mm_cmpeq_epi16
+            (
+                _mm_subs_epu16(shifted, _mm_set1_epi16(4)),
+                _mm_setzero_si128()
+            );
+
+            return _mm_or_si128(control, _mm_cmpeq_epi16(units, _mm_set1_epi16(' ')));
+        }
+
+        __m128i nonAsciiLanes_(__m128i units)
+        {
+            auto ascii = _mm_cmpeq_epi16
+            (
+                _mm_subs_epu16(units, _mm_set1_epi16(0x7F)),
+                _mm_setzero_si128()
+            );
+
+            return _mm_xor_si128(ascii, _mm_set1_epi16(-1));
+        }
+
+        // Two bits per unit (movemask works on bytes)
+        unsigned mask_(__m128i lanes)
+        {
+            return static_cast<unsigned>(_mm_movemask_epi8(lanes));
+        }
+
+        std::ptrdiff_t sse2MaybeSpace_(const char16_t* units, std::ptrdiff_t size)
+        {
+            std::ptrdiff_t i = 0;
+
+            for (; size - i >= BLOCK_; i += BLOCK_)
+            {
+                auto block = load_(units + i);
+                auto mask = mask_(_mm_or_si128(asciiSpaceLanes_(block), nonAsciiLanes_(block)));
+                if (mask != 0) return i + std::countr_zero(mask) / 2;
+            }
+
+            return i + scalarMaybeSpace_(units + i, size - i);
+        }
+
+        std::ptrdiff_t sse2MaybeNotSpace_(const char16_t* units, std::ptrdiff_t size)
+        {
+            std::ptrdiff_t i = 0;
+
+            for (; size - i >= BLOCK_; i += BLOCK_)
+            {
+                auto mask = ~mask_(asciiSpaceLanes_(load_(units + i))) & 0xFFFFu;
+                if (mask != 0) return i + std::countr_zero(mask) / 2;
+            }
+
+            return i + scalarMaybeNotSpace_(units + i, size - i);
+        }
+
+        std::ptrdiff_t sse2WidenPlainAscii_(const char* begin, const char* end, char16_t* out)
+        {
+            auto p = begin;
+            auto zero = _mm_setzero_si128();
+
+            while (end - p >= 16)
+            {
+                auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                auto stops = _mm_or_si128
+                (
+                    _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')),
+                    _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'))
+                );
+
+                // Movemask takes each byte's top bit, so that catches the
+                // bytes that start (or continue) a multibyte sequence too
+                auto mask = mask_(_mm_or_si128(stops, bytes));
+                auto at = out + (p - begin);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(at), _mm_unpacklo_epi8(bytes, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(at + 8), _mm_unpackhi_epi8(bytes, zero));
+
+                if (mask != 0)
+                    return (p - begin) + std::countr_zero(mask);
+
+                p += 16;
+            }
+
+            return (p - begin) + scalarWidenPlainAscii_(p, end, out + (p - begin));
+        }
+
+        // Whether the CPU (and OS, which has to save the wider registers)
+        // supports AVX2
+        bool cpuHasAvx2_()
+        {
+#if defined(_MSC_VER)
+            int info[4]{};
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+
+            // OSXSAVE and AVX, then whether the OS actually saves YMM state
+            __cpuid(info, 1);
+            if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+            if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__)
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        }
+
+#endif // SIMD_SSE2_
+
+        // Picked once, the first time anything here is used
+        const Kernels& kernels_()
+        {
+            static const Kernels kernels = []() -> Kernels
+                {
+#if defined(SIMD_SSE2_)
+                    if (SimdAvx2::compiled && cpuHasAvx2_())
+                    {
+                        return
+                        {
+                            "avx2",
+                            SimdAvx2::maybeSpace,
+                            SimdAvx2::maybeNotSpace,
+                            SimdAvx2::widenPlainAscii
+                        };
+                    }
+
+                    return { "sse2", sse2MaybeSpace_, sse2MaybeNotSpace_, sse2WidenPlainAscii_ };
+#else
+                    return { "scalar", scalarMaybeSpace_, scalarMaybeNotSpace_, scalarWidenPlainAscii_ };
+#endif
+                }();
+
+            return kernels;
+        }
+    }
+
+    qsizetype findSpace(QStringView text, qsizetype from)
+    {
+        auto units = text.utf16();
+        auto size = text.size();
+        auto maybe_space = kernels_().maybeSpace;
+        auto i = from;
+
+        while (i < size)
+        {
+            // Straight past plain ASCII, to something that might be
+            // whitespace (ASCII or not, which QChar decides)
+            i += maybe_space(units + i, size - i);
+            if (i >= size) break;
+
+            if (QChar::isSpace(units[i])) return i;
+            ++i;
+        }
+
+        return size;
+    }
+
+    qsizetype skipSpace(QStringView text, qsizetype from)
+    {
+        auto units = text.utf16();
+        auto size = text.size();
+        auto maybe_not_space = kernels_().maybeNotSpace;
+        auto i = from;
+
+        while (i < size)
+        {
+            i += maybe_not_space(units + i, size - i);
+            if (i >= size) break;
+
+            if (!QChar::isSpace(units[i])) return i;
+            ++i;
+        }
+
+        return size;
+    }
+
+    qsizetype widenPlainAscii(const char* begin, const char* end, char16_t* out)
+    {
+        return kernels_().widenPlainAscii(begin, end, out);
+    }
+
+    const char* instructionSet() noexcept
+    {
+        return kernels_().name;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QStringView>
+#include <QtTypes>
+
+// Block-at-a-time scans for the bulk paths (loading, simplify, word counts).
+// AVX2 when the CPU has it (picked at runtime, see SimdAvx2.h), else SSE2,
+// or plain loops on builds without either. The vector part only answers the
+// ASCII question; anything else is left to QChar one unit at a time, so
+// results always match QChar::isSpace
+namespace Simd
+{
+    // First whitespace at or after from (or text.size())
+    qsizetype findSpace(QStringView text, qsizetype from = 0);
+
+    // First non-whitespace at or after from (or text.size())
+    qsizetype skipSpace(QStringView text, qsizetype from = 0);
+
+    // Widens the leading run of bytes in [begin, end) that need no decoding
+    // (ASCII, other than a quote or backslash) into out, and returns its
+    // length. Out needs room for end - begin units, since whole blocks are
+    // written even when the run stops partway through one
+    qsizetype widenPlainAscii(const char* begin, const char* end, char16_t* out);
+
+    // "avx2", "sse2" or "scalar", for benchmark output
+    const char* instructionSet() noexcept;
+}
@@ -0,0 +1,172 @@
+// Built with AVX2 enabled (see SimdAvx2.h for why this includes so little)
+
+#include "SimdAvx2.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SimdAvx2
+{
+    namespace
+    {
+        // UTF-16 units per block
+        constexpr std::ptrdiff_t BLOCK_ = 16;
+
+        bool isAsciiSpace_(char16_t c) noexcept
+        {
+            return c == u' ' || (c >= u'\t' && c <= u'\r');
+        }
+
+        __m256i load_(const char16_t* p)
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        // Lanes that are \t to \r (9 to 13) or a space. Subtracting 9 puts
+        // the control range at 0 to 4, and anything else saturates past 4
+        __m256i asciiSpaceLanes_(__m256i units)
+        {
+            auto shifted = _mm256_sub_epi16(units, _mm256_set1_epi16(9));
+            auto control = _mm256_cmpeq_epi16
+            (
+                _mm256_subs_epu16(shifted, _mm256_set1_epi16(4)),
+                _mm256_setzero_si256()
+            );
+
+            return _mm256_or_si256(control, _mm256_cmpeq_epi16(units, _mm256_set1_epi16(' ')));
+        }
+
+        __m256i nonAsciiLanes_(__m256i units)
+        {
+            auto ascii = _mm256_cmpeq_epi16
+            (
+                _mm256_subs_epu16(units, _mm256_set1_epi16(0x7F)),
+                _mm256_setzero_si256()
+            );
+
+            return _mm256_xor_si256(ascii, _mm256_set1_epi16(-1));
+        }
+
+        // Two bits per unit (movemask works on bytes)
+        unsigned mask_(__m256i lanes)
+        {
+            return static_cast<unsigned>(_mm256_movemask_epi8(lanes));
+        }
+
+        std::ptrdiff_t firstLane_(unsigned mask)
+        {
+            // Never called with 0
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return static_cast<std::ptrdiff_t>(index);
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+    }
+
+    extern const bool compiled = true;
+
+    std::ptrdiff_t maybeSpace(const char16_t* units, std::ptrdiff_t size)
+    {
+        std::ptrdiff_t i = 0;
+
+        for (; size - i >= BLOCK_; i += BLOCK_)
+        {
+            auto block = load_(units + i);
+            auto mask = mask_(_mm256_or_si256(asciiSpaceLanes_(block), nonAsciiLanes_(block)));
+            if (mask != 0) return i + firstLane_(mask) / 2;
+        }
+
+        for (; i < size; ++i)
+            if (units[i] >= 0x80 || isAsciiSpace_(units[i]))
+                return i;
+
+        return size;
+    }
+
+    std::ptrdiff_t maybeNotSpace(const char16_t* units, std::ptrdiff_t size)
+    {
+        std::ptrdiff_t i = 0;
+
+        for (; size - i >= BLOCK_; i += BLOCK_)
+        {
+            auto mask = ~mask_(asciiSpaceLanes_(load_(units + i)));
+            if (mask != 0) return i + firstLane_(mask) / 2;
+        }
+
+        for (; i < size; ++i)
+            if (!isAsciiSpace_(units[i]))
+                return i;
+
+        return size;
+    }
+
+    std::ptrdiff_t widenPlainAscii(const char* begin, const char* end, char16_t* out)
+    {
+        auto p = begin;
+
+        while (end - p >= 32)
+        {
+            auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            auto stops = _mm256_or_si256
+            (
+                _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"')),
+                _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\\'))
+            );
+
+            // Movemask takes each byte's top bit, so that catches the bytes
+            // that start (or continue) a multibyte sequence as well
+            auto mask = mask_(_mm256_or_si256(stops, bytes));
+            auto at = out + (p - begin);
+
+            _mm256_storeu_si256
+            (
+                reinterpret_cast<__m256i*>(at),
+                _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes))
+            );
+
+            _mm256_storeu_si256
+            (
+                reinterpret_cast<__m256i*>(at + 16),
+                _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1))
+            );
+
+            if (mask != 0)
+                return (p - begin) + firstLane_(mask);
+
+            p += 32;
+        }
+
+        while (p < end)
+        {
+            auto c = static_cast<unsigned char>(*p);
+            if (c >= 0x80 || c == '"' || c == '\\') break;
+
+            out[p - begin] = c;
+            ++p;
+        }
+
+        return p - begin;
+    }
+}
+
+#else
+
+namespace SimdAvx2
+{
+    extern const bool compiled = false;
+
+    // Never picked (see compiled)
+    std::ptrdiff_t maybeSpace(const char16_t*, std::ptrdiff_t size) { return size; }
+    std::ptrdiff_t maybeNotSpace(const char16_t*, std::ptrdiff_t size) { return size; }
+    std::ptrdiff_t widenPlainAscii(const char*, const char*, char16_t*) { return 0; }
+}
+
+#endif // __AVX2__
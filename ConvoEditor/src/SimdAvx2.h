@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+// The AVX2 kernels behind Simd, which picks them at runtime when the CPU
+// has AVX2. SimdAvx2.cpp is the only file built with AVX2 enabled, so it
+// includes nothing but this and the intrinsics (no Qt, nothing with inline
+// code worth speaking of): an inline function compiled there could be the
+// copy the linker keeps for everyone, and use AVX2 on a CPU without it
+namespace SimdAvx2
+{
+    // False if SimdAvx2.cpp wasn't built with AVX2 enabled
+    extern const bool compiled;
+
+    // See Simd.cpp
+    std::ptrdiff_t maybeSpace(const char16_t* units, std::ptrdiff_t size);
+    std::ptrdiff_t maybeNotSpace(const char16_t* units, std::ptrdiff_t size);
+    std::ptrdiff_t widenPlainAscii(const char* begin, const char* end, char16_t* out);
+}
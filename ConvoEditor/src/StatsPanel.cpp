@@ -0,0 +1,75 @@
+#include <QAbstractItemView>
+#include <QHeaderView>
+#include <QStringList>
+#include <QTableWidget>
+#include <QTableWidgetItem>
+#include <QVBoxLayout>
+#include <QWidget>
+
+#include "Coco/Layout.h"
+
+#include "Logging.h"
+#include "RoleStats.h"
+#include "StatsPanel.h"
+
+StatsPanel::StatsPanel(QWidget* parent)
+    : QWidget(parent, Qt::Tool)
+{
+    initialize_();
+}
+
+StatsPanel::~StatsPanel()
+{
+    qCDebug(lcLifetime) << __FUNCTION__;
+}
+
+void StatsPanel::refresh(const RoleStats& stats, const QStringList& roles)
+{
+    table_->setRowCount(roles.count() + 1);
+
+    for (auto i = 0; i < roles.count(); ++i)
+        setRow_(i, roles.at(i), stats.role(roles.at(i)));
+
+    setRow_(roles.count(), "All", stats.total());
+}
+
+void StatsPanel::initialize_()
+{
+    setWindowTitle("Statistics");
+    resize(480, 240);
+
+    table_->setColumnCount(5);
+    table_->setHorizontalHeaderLabels({ "Role", "Turns", "Words", "Words/turn", "EOT" });
+    table_->verticalHeader()->hide();
+    table_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_->setSelectionMode(QAbstractItemView::NoSelection);
+
+    auto layout = Coco::Layout::zeroPadded<QVBoxLayout>(this);
+    layout->addWidget(table_);
+}
+
+void StatsPanel::setRow_(int row, const QString& label, const RoleStats::Totals& totals)
+{
+    QStringList cells
+    {
+        label,
+        QString::number(totals.turns),
+        QString::number(totals.words),
+        QString::number(totals.averageWords(), 'f', 1),
+        QString::number(totals.eotShare() * 100.0, 'f', 0) + "%"
+    };
+
+    for (auto column = 0; column < cells.count(); ++column)
+    {
+        auto item = table_->item(row, column);
+
+        if (!item)
+        {
+            item = new QTableWidgetItem;
+            table_->setItem(row, column, item);
+        }
+
+        item->setText(cells.at(column));
+    }
+}
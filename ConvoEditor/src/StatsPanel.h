@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+#include <QTableWidget>
+#include <QWidget>
+
+#include "RoleStats.h"
+
+// Shows RoleStats per role, plus a row for the whole document. It's a tool
+// window, so it can sit beside the main window while editing
+class StatsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StatsPanel(QWidget* parent = nullptr);
+    virtual ~StatsPanel() override;
+
+    void refresh(const RoleStats& stats, const QStringList& roles);
+
+private:
+    QTableWidget* table_ = new QTableWidget(this);
+
+    void initialize_();
+    void setRow_(int row, const QString& label, const RoleStats::Totals& totals);
+};
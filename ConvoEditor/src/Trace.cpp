@@ -0,0 +1,153 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <QIODevice>
+#include <QString>
+#include <QtTypes>
+
+#include "Trace.h"
+
+namespace Trace
+{
+    namespace
+    {
+        struct Event
+        {
+            const char* name = nullptr;
+            qint64 start = 0;
+            qint64 duration = 0;
+        };
+
+        // Single producer (its thread). The head only ever grows; the slot
+        // is head % CAPACITY_
+        struct Ring
+        {
+            static constexpr qsizetype CAPACITY_ = 1 << 16;
+
+            int thread = 0;
+            std::array<Event, CAPACITY_> events{};
+            std::atomic<quint64> head{ 0 };
+        };
+
+        // Rings are registered once per thread (the only lock) and kept
+        // after their threads exit, so their spans can still be dumped
+        std::mutex& registryMutex_()
+        {
+            static std::mutex mutex{};
+            return mutex;
+        }
+
+        std::vector<std::unique_ptr<Ring>>& registry_()
+        {
+            static std::vector<std::unique_ptr<Ring>> rings{};
+            return rings;
+        }
+
+        Ring& ring_()
+        {
+            thread_local Ring* ring = nullptr;
+
+            if (!ring)
+            {
+                std::lock_guard lock(registryMutex_());
+                auto& rings = registry_();
+                rings.push_back(std::make_unique<Ring>());
+                ring = rings.back().get();
+                ring->thread = static_cast<int>(rings.size());
+            }
+
+            return *ring;
+        }
+
+        qint64 nowNs_() noexcept
+        {
+            using namespace std::chrono;
+            static const auto epoch = steady_clock::now();
+            return duration_cast<nanoseconds>(steady_clock::now() - epoch).count();
+        }
+    }
+
+    Span::Span(const char* name) noexcept
+        : name_(name), start_(nowNs_())
+    {
+    }
+
+    Span::~Span()
+    {
+        auto& ring = ring_();
+        auto head = ring.head.load(std::memory_order_relaxed);
+        ring.events[head % Ring::CAPACITY_] = { name_, start_, nowNs_() - start_ };
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    bool enabled() noexcept
+    {
+#ifdef CONVO_TRACE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool dump(const QString& path)
+    {
+        if (!enabled())
+        {
+            qWarning() << "Tracing isn't compiled in (define CONVO_TRACE)";
+            return false;
+        }
+
+        QFile file(path);
+
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            qWarning() << "Couldn't open trace output:" << path;
+            return false;
+        }
+
+        // Complete ("X") events, in microseconds. Written by hand; there
+        // can be a lot of them
+        file.write("{\"traceEvents\":[\n");
+        auto first = true;
+
+        std::lock_guard lock(registryMutex_());
+
+        for (auto& ring : registry_())
+        {
+            auto head = ring->head.load(std::memory_order_acquire);
+            auto count = qMin<quint64>(head, Ring::CAPACITY_);
+
+            for (auto i = head - count; i < head; ++i)
+            {
+                const auto& event = ring->events[i % Ring::CAPACITY_];
+                if (!event.name) continue;
+
+                QByteArray line{};
+                if (!first) line += ",\n";
+                first = false;
+
+                line += "{\"name\":\"";
+                line += QByteArray(event.name).replace('"', "\\\"");
+                line += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+                line += QByteArray::number(ring->thread);
+                line += ",\"ts\":";
+                line += QByteArray::number(event.start / 1000.0, 'f', 3);
+                line += ",\"dur\":";
+                line += QByteArray::number(event.duration / 1000.0, 'f', 3);
+                line += "}";
+
+                file.write(line);
+            }
+        }
+
+        file.write("\n]}\n");
+        return true;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QString>
+#include <QtTypes>
+
+// Scoped timing spans, dumped as Chrome trace JSON (chrome://tracing or
+// ui.perfetto.dev). Only compiled in with CONVO_TRACE defined; otherwise
+// TRACE_SPAN is nothing at all
+//
+// Each thread records into its own fixed-size ring buffer, so recording
+// takes no locks and old spans are overwritten once it's full. Names must
+// be string literals (they're stored as pointers)
+namespace Trace
+{
+    class Span
+    {
+    public:
+        explicit Span(const char* name) noexcept;
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* name_;
+        qint64 start_;
+    };
+
+    bool enabled() noexcept;
+
+    // Writes everything still in the buffers. Best taken once the threads
+    // being traced are quiet
+    bool dump(const QString& path);
+}
+
+#ifdef CONVO_TRACE
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_NAME_(line) TRACE_CONCAT_(trace_span_, line)
+#define TRACE_SPAN(name) Trace::Span TRACE_NAME_(__LINE__)(name)
+
+#else
+
+#define TRACE_SPAN(name) ((void)0)
+
+#endif // CONVO_TRACE
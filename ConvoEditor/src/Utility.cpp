@@ -1,12 +1,78 @@
 #include <QChar>
 #include <QList>
 #include <QString>
+#include <QStringList>
+#include <QStringView>
 #include <QtTypes>
 
+#include "Simd.h"
 #include "Utility.h"
 
 namespace Utility
 {
+    namespace
+    {
+        // Titles and such that end in a period but not a sentence
+        bool isAbbreviation_(const QString& text, qsizetype periodPosition)
+        {
+            // Back through letters, and through periods with a letter on
+            // either side ("e.g", "U.S")
+            auto start = periodPosition;
+
+            while (start > 0
+                && (text.at(start - 1).isLetter()
+                    || (text.at(start - 1) == '.' && start > 1 && text.at(start - 2).isLetter())))
+                --start;
+
+            auto word = text.mid(start, periodPosition - start).toLower();
+
+            // Initials ("J. Smith"), and dotted single letters ("e.g.",
+            // "i.e.", "a.m.", "U.S.")
+            if (word.length() == 1) return true;
+
+            auto dotted = word.length() % 2 == 1;
+
+            for (auto i = 1; dotted && i < word.length(); i += 2)
+                dotted = word.at(i) == '.';
+
+            if (dotted) return true;
+
+            return word == "mr"
+                || word == "mrs"
+                || word == "ms"
+                || word == "dr"
+                || word == "st"
+                || word == "vs"
+                || word == "etc";
+        }
+
+        // Positions just past the end of each sentence (after any closing
+        // quotes), where the next one starts after whitespace
+        QList<qsizetype> sentenceBoundaries_(const QString& text)
+        {
+            QList<qsizetype> boundaries{};
+
+            for (qsizetype i = 0; i < text.length(); ++i)
+            {
+                auto c = text.at(i);
+                if (c != '.' && c != '!' && c != '?') continue;
+
+                auto end = i + 1;
+
+                while (end < text.length()
+                    && (text.at(end) == '"' || text.at(end) == '\''))
+                    ++end;
+
+                if (end >= text.length() || !text.at(end).isSpace()) continue;
+                if (c == '.' && isAbbreviation_(text, i)) continue;
+
+                boundaries << end;
+            }
+
+            return boundaries;
+        }
+    }
+
     void shiftPunct(QString& before, QString& after)
     {
         // Before: "This is before"
@@ -102,4 +168,153 @@ namespace Utility
         beginning += indicator;
         end.prepend(indicator);
     }
+
+    QString join(const QString& before, const QString& after, int* joinPosition, const char* indicator)
+    {
+        auto left = before.trimmed();
+        auto right = after.trimmed();
+        QString separator(" ");
+
+        // A word that was split mid-way
+        QString indicator_string(indicator);
+
+        if (left.endsWith(indicator_string) && right.startsWith(indicator_string))
+        {
+            left.chop(indicator_string.length());
+            right.remove(0, indicator_string.length());
+            separator.clear();
+        }
+
+        if (left.isEmpty() || right.isEmpty())
+            separator.clear();
+
+        if (joinPosition)
+            *joinPosition = static_cast<int>(left.length() + separator.length());
+
+        return left + separator + right;
+    }
+
+    bool isSimplified(const QString& text)
+    {
+        // Simple is one plain space between words, and none at the ends
+        QStringView view(text);
+        auto size = view.size();
+        if (Simd::skipSpace(view) != 0) return false;
+
+        for (qsizetype i = 0; i < size; )
+        {
+            auto gap = Simd::findSpace(view, i);
+            if (gap == size) return true;
+
+            i = Simd::skipSpace(view, gap);
+            if (i != gap + 1 || i == size || view[gap] != u' ') return false;
+        }
+
+        return true;
+    }
+
+    QString simplified(const QString& text)
+    {
+        if (isSimplified(text)) return text;
+
+        QStringView view(text);
+        auto size = view.size();
+        QString result{};
+        result.reserve(size);
+
+        // Word by word, with one space between
+        for (auto i = Simd::skipSpace(view); i < size; )
+        {
+            auto gap = Simd::findSpace(view, i);
+
+            if (!result.isEmpty()) result += u' ';
+            result += view.mid(i, gap - i);
+
+            i = Simd::skipSpace(view, gap);
+        }
+
+        return result;
+    }
+
+    QList<int> simplifiedPositions(const QString& text)
+    {
+        QStringView view(text);
+        auto size = view.size();
+        QList<int> map(size);
+        auto simplified_pos = 0;
+
+        // Leading whitespace is dropped, so it all maps to 0 (which the map
+        // starts out as)
+        auto i = Simd::skipSpace(view);
+
+        while (i < size)
+        {
+            auto gap = Simd::findSpace(view, i);
+
+            for (; i < gap; ++i)
+                map[i] = simplified_pos++;
+
+            if (gap == size) break;
+
+            // A whitespace run becomes one space. The run's first character
+            // maps to that space, and the rest to just past it
+            auto next = Simd::skipSpace(view, gap);
+            map[gap] = simplified_pos++;
+
+            for (i = gap + 1; i < next; ++i)
+                map[i] = simplified_pos;
+        }
+
+        return map;
+    }
+
+    QStringList splitSentences(const QString& text, int maxLength)
+    {
+        if (text.length() <= maxLength) return {};
+
+        auto boundaries = sentenceBoundaries_(text);
+        if (boundaries.isEmpty()) return {};
+
+        // Greedy: cut at the last boundary that keeps the piece in bounds
+        // (or the first one past it, if a single sentence is too long). The
+        // end of the text is treated as one more boundary, but never cut at
+        boundaries << text.length();
+
+        QList<qsizetype> cuts{};
+        qsizetype start = 0;
+        qsizetype last_fit = 0;
+
+        for (auto boundary : boundaries)
+        {
+            while (boundary - start > maxLength)
+            {
+                auto cut = (last_fit > start) ? last_fit : boundary;
+                if (cut >= text.length()) break;
+
+                cuts << cut;
+                start = cut;
+            }
+
+            if (boundary > start) last_fit = boundary;
+        }
+
+        if (cuts.isEmpty()) return {};
+
+        QStringList pieces{};
+        start = 0;
+
+        for (auto cut : cuts)
+        {
+            pieces << text.mid(start, cut - start).trimmed();
+            start = cut;
+        }
+
+        pieces << text.mid(start).trimmed();
+
+        for (auto i = 1; i < pieces.count(); ++i)
+            shiftPunct(pieces[i - 1], pieces[i]);
+
+        pieces.removeAll(QString{});
+        return pieces.count() > 1 ? pieces : QStringList{};
+    }
 }
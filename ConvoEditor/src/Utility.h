@@ -1,10 +1,37 @@
 #pragma once
 
+#include <QList>
 #include <QString>
+#include <QStringList>
 
 namespace Utility
 {
     void shiftPunct(QString& before, QString& after);
     bool wouldBreakWord(const QString& text, int splitPosition);
     void applyBreakIndicators(QString& beginning, QString& end, const char* indicator = "--");
+
+    // The reverse of a split: joins with a space, or with nothing if both
+    // sides carry break indicators (which are removed). joinPosition, if
+    // given, is set to where after's text starts in the result
+    QString join
+    (
+        const QString& before,
+        const QString& after,
+        int* joinPosition = nullptr,
+        const char* indicator = "--"
+    );
+
+    // Breaks text longer than maxLength into pieces at sentence boundaries,
+    // packing as many whole sentences into each piece as fit. Returns
+    // nothing if the text is short enough or has nowhere to break
+    QStringList splitSentences(const QString& text, int maxLength);
+
+    // Same result as QString::simplified, but it checks first and hands
+    // text back as it is (no copy) when there's nothing to do, which is
+    // usually the case
+    bool isSimplified(const QString& text);
+    QString simplified(const QString& text);
+
+    // Where each position in text ends up in simplified(text)
+    QList<int> simplifiedPositions(const QString& text);
 }
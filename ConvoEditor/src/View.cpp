@@ -1,29 +1,42 @@
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
+#include <QAbstractAnimation>
 #include <QApplication>
-#include <QDebug>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QEasingCurve>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QHBoxLayout>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonValue>
+#include <QIODevice>
 #include <QList>
+#include <QMouseEvent>
 #include <QObject>
-#include <QPoint>
+#include <QPointer>
 #include <QPropertyAnimation>
 #include <QRect>
+#include <QSaveFile>
 #include <QScrollArea>
 #include <QScrollBar>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QTextCursor>
+#include <QTextDocument>
 #include <QTextDocumentFragment>
 #include <QTimer>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include <QtTypes>
 #include <QVBoxLayout>
 #include <QWidget>
 
-#include "Coco/Io.h"
+#include "Coco/Fx.h"
 #include "Coco/Layout.h"
 #include "Coco/Path.h"
 #include "Coco/Utility.h"
@@ -31,8 +44,19 @@
 #include "AutoSizeTextEdit.h"
 #include "Element.h"
 #include "Eot.h"
+#include "Filter.h"
+#include "FilterBar.h"
 #include "InsertButton.h"
 #include "LoadPlan.h"
+#include "Logging.h"
+#include "Minimap.h"
+#include "Replace.h"
+#include "ReplaceBar.h"
+#include "RoleStats.h"
+#include "SearchBar.h"
+#include "SearchIndex.h"
+#include "StatsPanel.h"
+#include "Trace.h"
 #include "Utility.h"
 #include "View.h"
 
@@ -61,52 +85,161 @@ View::View(QWidget* parent)
 
 View::~View()
 {
-    qDebug() << __FUNCTION__;
+    qCDebug(lcLifetime) << __FUNCTION__;
 }
 
-bool View::load(const Coco::Path& path)
+namespace
+{
+    // Sets target to how long the enclosing scope took, in ms, unless
+    // cancelled (so a failed load doesn't replace the last good time)
+    class ScopedMs
+    {
+    public:
+        explicit ScopedMs(double& target) : target_(target) { timer_.start(); }
+
+        ~ScopedMs()
+        {
+            if (!cancelled_)
+                target_ = timer_.nsecsElapsed() / 1'000'000.0;
+        }
+
+        void cancel() noexcept { cancelled_ = true; }
+
+        ScopedMs(const ScopedMs&) = delete;
+        ScopedMs& operator=(const ScopedMs&) = delete;
+
+    private:
+        double& target_;
+        QElapsedTimer timer_{};
+        bool cancelled_ = false;
+    };
+
+    // Quoted and escaped the way QJsonDocument writes strings (UTF-8 as is,
+    // escapes only where JSON needs them)
+    void appendJsonString_(QByteArray& out, const QString& text)
+    {
+        static constexpr char HEX_[] = "0123456789abcdef";
+        out += '"';
+
+        for (auto c : text.toUtf8())
+        {
+            switch (c)
+            {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out += "\\u00";
+                    out += HEX_[(c >> 4) & 0xF];
+                    out += HEX_[c & 0xF];
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+
+        out += '"';
+    }
+}
+
+View::Metrics View::metrics() const
 {
-    auto document = Coco::Io::Json::read(path);
-    if (document.isNull()) return false;
+    Metrics metrics{};
+    metrics.elements = elements_.count();
+    metrics.shown = shown_().count();
+    metrics.lastLoadMs = lastLoadMs_;
+    metrics.lastSaveMs = lastSaveMs_;
+    metrics.lastSplitMs = lastSplitMs_;
+
+    // Kept up to date per element, as elements change (see RoleStats)
+    metrics.textCharacters = stats_.total().characters;
 
-    // No errors, so loading will proceed
-    QList<Element*> old_elements = elements_;
-    QList<InsertButton*> old_insert_buttons = insertButtons_;
-    QList<QString> old_role_choices = roleChoices_;
-    elements_.clear(); // move to clear all widgets?
-    insertButtons_.clear(); // move to clear all widgets?
-    roleChoices_.clear(); // Also, can't we just not clear these till after plan isn't null lol?
+    return metrics;
+}
+
+bool View::load(const Coco::Path& path)
+{
+    TRACE_SPAN("View::load");
+    ScopedMs timing(lastLoadMs_);
 
-    auto plan = parse_(document);
+    QFile file(path.toQString());
 
-    if (!plan.isNull())
+    if (!file.open(QIODevice::ReadOnly))
     {
-        currentPath_ = path;
-        clearAllContent_();
-        populate_(plan);
-        scrollArea_->verticalScrollBar()->setValue(0);
+        qCWarning(lcIo) << "Couldn't open" << file.fileName();
+        timing.cancel();
+        return false;
+    }
+
+    auto plan = parse_(file.readAll());
+    file.close();
 
-        emit documentLoaded();
-        return true;
+    if (plan.isNull())
+    {
+        qCWarning(lcIo) << "JSON format is incorrect. Expected:" << EXPECTED;
+        timing.cancel();
+        return false;
     }
 
-    qWarning() << "JSON format is incorrect. Expected:" << EXPECTED;
-    elements_ = old_elements;
-    insertButtons_ = old_insert_buttons;
-    roleChoices_ = old_role_choices;
+    // No errors, so loading will proceed. The new document is built in a
+    // fresh container off-screen and swapped in all at once. The old one is
+    // torn down afterward, in the background
+    currentPath_ = path;
+    currentEdit_ = nullptr;
+
+    // Nothing from the old document gets to scroll the new one (a queued
+    // scroll finds no target and does nothing)
+    scrollAnimation_->stop();
+    scrollTarget_ = nullptr;
+
+    auto old_container = contentContainer_;
+    setContentContainer_(makeContentContainer_());
+    contentContainer_->resize(scrollArea_->viewport()->size());
+    elements_.clear();
+    roleChoices_.clear();
+    stats_.clear();
+    reflowQueue_.clear();
+    populate_(plan);
+    rebuildSearchIndex_(plan);
+    applyFilter_();
+    queueStatsRefresh_();
+    resetMinimap_();
+
+    scrollArea_->takeWidget();
+    scrollArea_->setWidget(contentContainer_);
+    scrollArea_->verticalScrollBar()->setValue(0);
+    discardContentContainer_(old_container);
 
-    return false;
+    emit documentLoaded();
+    return true;
 }
 
 bool View::save()
 {
+    TRACE_SPAN("View::save");
+    ScopedMs timing(lastSaveMs_);
     if (currentPath_.isEmpty()) return false;
     if (currentEdit_) currentEdit_->simplify();
 
-    auto document = compile_();
-    if (document.isNull()) return false;
+    QSaveFile file(currentPath_.toQString());
 
-    return Coco::Io::Json::write(document, currentPath_);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(lcIo) << "Couldn't open" << file.fileName();
+        return false;
+    }
+
+    file.write(compile_());
+    return file.commit();
 }
 
 void View::split(bool forceTripart, int tripartRole)
@@ -122,14 +255,27 @@ void View::split(bool forceTripart, int tripartRole)
     // middle element (useful for quickly splitting as an interruption)
     // 
     // Automatically adjusts EOT based on punctuation.
+    //
+    // If the edit has split markers (Ctrl+M), it's split at all of them
+    // instead (see splitAtMarkers_)
+    TRACE_SPAN("View::split");
+    ScopedMs timing(lastSplitMs_);
     if (!currentEdit_) return;
 
+    Transaction transaction(this);
+
     auto initial_element = Coco::findParent<Element>(currentEdit_);
     if (!initial_element) return;
 
     auto index = elements_.indexOf(initial_element);
     if (index < 0) return;
 
+    if (auto markers = currentEdit_->splitMarkers(); !markers.isEmpty())
+    {
+        splitAtMarkers_(initial_element, markers);
+        return;
+    }
+
     auto cursor = currentEdit_->textCursor();
     auto position = cursor.position();
     auto has_selection = cursor.hasSelection();
@@ -162,11 +308,11 @@ void View::split(bool forceTripart, int tripartRole)
         LoadPlan::Item item
         {
             initial_element->role(),
-            after_text,
+            std::move(after_text),
             initial_element->eot()
         };
 
-        scroll_to = insertElement_(index + 1, item);
+        scroll_to = insertElement_(index + 1, std::move(item));
     }
     else // has_selection || forceTripart
     {
@@ -179,15 +325,15 @@ void View::split(bool forceTripart, int tripartRole)
             };
 
         auto tripart_insert =
-            [](View* v, int insertIndex, const LoadPlan::Item& middle, const LoadPlan::Item& after) noexcept
+            [](View* v, int insertIndex, LoadPlan::Item middle, LoadPlan::Item after) noexcept
             {
                 // Insert the elements: after first, then middle (which puts
                 // middle between initial and after)
 
                 // Capturing after index is pointless, because it
                 // immediately changes
-                v->insertElement_(insertIndex, after);
-                auto middle_index = v->insertElement_(insertIndex, middle);
+                v->insertElement_(insertIndex, std::move(after));
+                auto middle_index = v->insertElement_(insertIndex, std::move(middle));
                 return std::pair<int, int>{ middle_index, middle_index + 1 };
             };
 
@@ -223,7 +369,7 @@ void View::split(bool forceTripart, int tripartRole)
             LoadPlan::Item after_item
             {
                 initial_role,
-                after_text,
+                std::move(after_text),
                 initial_element->eot()
             };
 
@@ -231,8 +377,8 @@ void View::split(bool forceTripart, int tripartRole)
             (
                 this,
                 index + 1,
-                middle_item,
-                after_item
+                std::move(middle_item),
+                std::move(after_item)
             );
 
             scroll_to = indexes.second;
@@ -273,14 +419,14 @@ void View::split(bool forceTripart, int tripartRole)
             LoadPlan::Item middle_item
             {
                 get_tripart_role(tripartRole, roleChoices_, initial_role),
-                middle_text,
+                std::move(middle_text),
                 false
             };
 
             LoadPlan::Item after_item
             {
                 initial_role,
-                after_text,
+                std::move(after_text),
                 initial_element->eot()
             };
 
@@ -288,8 +434,8 @@ void View::split(bool forceTripart, int tripartRole)
             (
                 this,
                 index + 1,
-                middle_item,
-                after_item
+                std::move(middle_item),
+                std::move(after_item)
             );
 
             eotAdjust_(elements_.at(indexes.first));
@@ -299,7 +445,205 @@ void View::split(bool forceTripart, int tripartRole)
 
     initial_element->setSpeech(before_text);
     eotAdjust_(initial_element);
-    scrollToContent_(((scroll_to * 2) + 1) + 1); // Include the button container
+    scrollToContent_(elements_.at(scroll_to));
+}
+
+void View::splitAtMarkers_(Element* element, const QList<int>& markers)
+{
+    // N markers make N + 1 elements, inserted in one pass with one scroll.
+    // Each cut is treated like a bipart split: punctuation shifted back,
+    // break indicators if it cuts a word
+    auto text = element->speech();
+    QStringList pieces{};
+    QList<bool> breaks{};
+    auto start = 0;
+
+    for (auto marker : markers)
+    {
+        pieces << text.mid(start, marker - start).trimmed();
+        breaks << Utility::wouldBreakWord(text, marker);
+        start = marker;
+    }
+
+    pieces << text.mid(start).trimmed();
+
+    for (auto i = 0; i < breaks.count(); ++i)
+    {
+        Utility::shiftPunct(pieces[i], pieces[i + 1]);
+
+        if (breaks.at(i))
+            Utility::applyBreakIndicators(pieces[i], pieces[i + 1]);
+    }
+
+    pieces.removeAll(QString{});
+    element->speechEdit()->clearSplitMarkers();
+    if (pieces.count() < 2) return;
+
+    auto role = element->role();
+    auto eot = element->eot();
+    QList<LoadPlan::Item> items{};
+
+    items.reserve(pieces.count() - 1);
+
+    for (auto i = 1; i < pieces.count(); ++i)
+        items << LoadPlan::Item{ role, std::move(pieces[i]), eot };
+
+    element->setSpeech(pieces.first());
+    eotAdjust_(element);
+
+    auto inserted = insertElements_(elements_.indexOf(element) + 1, std::move(items));
+
+    for (auto i = 0; i < inserted.count() - 1; ++i)
+        eotAdjust_(inserted.at(i));
+
+    auto last_edit = inserted.last()->speechEdit();
+    auto cursor = last_edit->textCursor();
+    cursor.movePosition(QTextCursor::End);
+    last_edit->setTextCursor(cursor);
+    last_edit->setFocus();
+
+    scrollToContent_(inserted.last());
+}
+
+void View::merge()
+{
+    // Merges the current element with the next one, keeping the current
+    // element's role and taking the next one's EOT. With a filter on, the
+    // next one has to be shown too (merging never reaches over turns that
+    // are hidden, and never into one the user can't see)
+    if (!currentEdit_) return;
+
+    auto element = Coco::findParent<Element>(currentEdit_);
+    if (!element) return;
+
+    auto index = elements_.indexOf(element);
+    if (index < 0 || index + 1 >= elements_.count()) return;
+
+    auto next = elements_.at(index + 1);
+    if (filterActive_ && !filtered_.contains(next)) return;
+
+    auto join_position = 0;
+    auto joined = Utility::join(element->speech(), next->speech(), &join_position);
+
+    {
+        Transaction transaction(this);
+
+        element->setSpeech(joined);
+        element->setEot(next->eot());
+        removeElement_(next);
+    }
+
+    auto edit = element->speechEdit();
+    auto cursor = edit->textCursor();
+    cursor.setPosition(join_position);
+    edit->setTextCursor(cursor);
+    edit->setFocus();
+}
+
+void View::mergeAll()
+{
+    TRACE_SPAN("View::mergeAll");
+    // Joins runs of consecutive same-role elements, for as long as the run
+    // so far doesn't end a turn (ASR output likes to chop one sentence into
+    // several). Works out every run from a snapshot first, then applies the
+    // lot at once
+    if (currentEdit_)
+        currentEdit_->simplify();
+
+    struct Run
+    {
+        Element* head = nullptr;
+        QString speech{};
+        bool eot = false;
+        QList<Element*> rest{};
+    };
+
+    QList<Run> runs{};
+    Run run{};
+
+    auto flush = [&]
+        {
+            if (run.head && !run.rest.isEmpty()) runs << run;
+            run = {};
+        };
+
+    for (auto& element : elements_)
+    {
+        if (run.head && !run.eot && element->role() == run.head->role())
+        {
+            run.speech = Utility::join(run.speech, element->speech());
+            run.eot = element->eot();
+            run.rest << element;
+            continue;
+        }
+
+        flush();
+        run.head = element;
+        run.speech = element->speech();
+        run.eot = element->eot();
+    }
+
+    flush();
+    if (runs.isEmpty()) return;
+
+    Transaction transaction(this);
+
+    for (auto& merged : runs)
+    {
+        merged.head->setSpeech(merged.speech);
+        merged.head->setEot(merged.eot);
+
+        for (auto& element : merged.rest)
+            removeElement_(element);
+    }
+}
+
+void View::splitLongTurns(int maxLength)
+{
+    TRACE_SPAN("View::splitLongTurns");
+    // Splits every element longer than maxLength at sentence boundaries.
+    // The pieces are worked out for all elements at once, in parallel, then
+    // inserted in one pass. Pieces keep their element's role. EOT is
+    // adjusted for all but the last, which keeps the element's own
+    if (currentEdit_)
+        currentEdit_->simplify();
+
+    auto pieces = QtConcurrent::blockingMapped<QList<QStringList>>
+        (
+            speeches_(),
+            [maxLength](const QString& speech)
+            {
+                return Utility::splitSentences(speech, maxLength);
+            }
+        );
+
+    auto snapshot = elements_.toList();
+    Transaction transaction(this);
+
+    // Back to front, so the indexes of what's left to do don't move
+    for (auto i = static_cast<int>(pieces.count()) - 1; i >= 0; --i)
+    {
+        auto& turn_pieces = pieces[i];
+        if (turn_pieces.isEmpty()) continue;
+
+        auto element = snapshot.at(i);
+        auto role = element->role();
+        auto eot = element->eot();
+
+        QList<LoadPlan::Item> items{};
+        items.reserve(turn_pieces.count() - 1);
+
+        for (auto j = 1; j < turn_pieces.count(); ++j)
+            items << LoadPlan::Item{ role, std::move(turn_pieces[j]), eot };
+
+        element->setSpeech(turn_pieces.first());
+        eotAdjust_(element);
+
+        auto inserted = insertElements_(i + 1, std::move(items));
+
+        for (auto j = 0; j < inserted.count() - 1; ++j)
+            eotAdjust_(inserted.at(j));
+    }
 }
 
 void View::initialize_()
@@ -308,15 +652,55 @@ void View::initialize_()
     scrollArea_->setWidgetResizable(true);
     scrollArea_->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     scrollArea_->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setContentContainer_(makeContentContainer_());
     scrollArea_->setWidget(contentContainer_);
 
     // Set up layouts
     // Align center causes widgets to take up their preferred size rather
     // than stretching to fill the available width
     mainLayout_ = Coco::Layout::zeroPadded<QVBoxLayout>(this, Qt::AlignCenter);
-    contentLayout_ = Coco::Layout::zeroPadded<QVBoxLayout>(contentContainer_, Qt::AlignCenter);
+    mainLayout_->addWidget(searchBar_);
+    mainLayout_->addWidget(replaceBar_);
+    mainLayout_->addWidget(filterBar_);
+
+    auto content_row_layout = Coco::Layout::zeroPadded<QHBoxLayout>();
+    content_row_layout->addWidget(scrollArea_, 1);
+    content_row_layout->addWidget(minimap_, 0);
+    mainLayout_->addLayout(content_row_layout);
+    searchBar_->hide();
+    replaceBar_->hide();
+    filterBar_->hide();
+
+    // Scroll animation setup
+    scrollAnimation_ = new QPropertyAnimation(scrollArea_->verticalScrollBar(), "value", this);
+    scrollAnimation_->setDuration(300);
+    scrollAnimation_->setEasingCurve(QEasingCurve::OutCubic);
+
+    // Insert button setup (it's shown on hover, by the event filter)
+    insertButton_->setText("+");
+    insertButton_->setFixedSize(25, 25);
+    insertButton_->hide();
+
+    connect
+    (
+        scrollAnimation_,
+        &QPropertyAnimation::finished,
+        this,
+        [&] { scrollTarget_ = nullptr; }
+    );
 
-    mainLayout_->addWidget(scrollArea_);
+    connect
+    (
+        insertButton_,
+        &InsertButton::insertRequested,
+        this,
+        [&](int position)
+        {
+            insertButton_->hide();
+            auto element_index = insertElement_(position);
+            scrollToContent_(elements_.at(element_index));
+        }
+    );
 
     connect
     (
@@ -325,46 +709,148 @@ void View::initialize_()
         this,
         &View::onQAppFocusChanged_
     );
+
+    connect
+    (
+        searchBar_,
+        &SearchBar::queryChanged,
+        this,
+        &View::onSearchQueryChanged_
+    );
+
+    connect
+    (
+        searchBar_,
+        &SearchBar::nextRequested,
+        this,
+        [&] { goToSearchHit_(searchHitIndex_ + 1); }
+    );
+
+    connect
+    (
+        searchBar_,
+        &SearchBar::previousRequested,
+        this,
+        [&] { goToSearchHit_(searchHitIndex_ - 1); }
+    );
+
+    connect
+    (
+        replaceBar_,
+        &ReplaceBar::optionsChanged,
+        this,
+        &View::previewReplace_
+    );
+
+    connect
+    (
+        replaceBar_,
+        &ReplaceBar::replaceAllRequested,
+        this,
+        &View::replaceAll_
+    );
+
+    connect
+    (
+        replaceBar_,
+        &ReplaceBar::undoRequested,
+        this,
+        &View::undoReplace_
+    );
+
+    connect
+    (
+        filterBar_,
+        &FilterBar::filterChanged,
+        this,
+        &View::applyFilter_
+    );
+
+    connect
+    (
+        minimap_,
+        &Minimap::turnClicked,
+        this,
+        [&](int index) { jumpTo_(elements_.at(index)); }
+    );
+
+    connect
+    (
+        scrollArea_->verticalScrollBar(),
+        &QScrollBar::valueChanged,
+        this,
+        &View::updateMinimapViewport_
+    );
+
+    connect
+    (
+        scrollArea_->verticalScrollBar(),
+        &QScrollBar::valueChanged,
+        this,
+        &View::reflowVisible_
+    );
+}
+
+QWidget* View::makeContentContainer_()
+{
+    // Created without a parent, so it can be filled off-screen. The scroll
+    // area takes ownership when it's set as its widget
+    auto container = new QWidget;
+
+    // Align center causes widgets to take up their preferred size rather
+    // than stretching to fill the available width
+    Coco::Layout::make<QVBoxLayout>
+        (
+            { 0, GAP_, 0, GAP_ }, GAP_,
+            container,
+            Qt::AlignCenter
+        );
+
+    // For the insert button
+    container->setMouseTracking(true);
+    container->installEventFilter(this);
+
+    return container;
 }
 
-void View::scrollToContent_(int contentIndex)
+void View::setContentContainer_(QWidget* container)
 {
-    // I hate timers.
+    contentContainer_ = container;
+    contentLayout_ = qobject_cast<QVBoxLayout*>(container->layout());
 
-    // Use QTimer to ensure widget is laid out before scrolling. When using
-    // interval 0, the scroll doesn't work at end of document
-    QTimer::singleShot(100, this, [=]() {
-        auto scroll_bar = scrollArea_->verticalScrollBar();
-        if (!scroll_bar) return;
+    insertButton_->hide();
+    insertButton_->setParent(container);
+}
 
-        auto widget = contentLayout_->itemAt(contentIndex)->widget();
-        if (!widget) return;
+void View::discardContentContainer_(QWidget* container)
+{
+    if (!container) return;
 
-        /// Testing (don't scroll if widget is already visible)
-        ///----------------------------------
+    // Keep it parented (and hidden) so it can't leak if we're destroyed
+    // before it's gone
+    container->setParent(this);
+    container->hide();
+    container->setUpdatesEnabled(false);
+    if (auto layout = container->layout()) layout->setEnabled(false);
 
-        auto viewport = scrollArea_->viewport();
-        auto widget_top_left = widget->mapTo(viewport, QPoint(0, 0));
-        auto widget_bottom_right = widget->mapTo(viewport, QPoint(widget->width(), widget->height()));
-        QRect viewport_rect(0, 0, viewport->width(), viewport->height());
-        QRect widget_rect(widget_top_left, widget_bottom_right);
-        if (viewport_rect.contains(widget_rect)) return;
+    discardedContainers_ << container;
 
-        ///----------------------------------
+    if (!teardownQueued_)
+    {
+        teardownQueued_ = true;
+        QTimer::singleShot(0, this, &View::teardownSlice_);
+    }
+}
 
-        auto widget_bottom = widget->mapTo(contentContainer_, QPoint(0, widget->height())).y();
-        auto viewport_height = scrollArea_->viewport()->height();
-        auto to = widget_bottom - viewport_height;
-        to = qBound(0, to, scroll_bar->maximum());
-        auto from = scroll_bar->value();
+void View::scrollToContent_(QWidget* content)
+{
+    // Scrolling waits for the content layout to settle instead of guessing
+    // with a timer. Requests made before that happens (e.g. back-to-back
+    // splits) just retarget
+    if (!content) return;
 
-        auto animation = new QPropertyAnimation(scroll_bar, "value");
-        animation->setDuration(300);
-        animation->setStartValue(from);
-        animation->setEndValue(to);
-        animation->setEasingCurve(QEasingCurve::OutCubic);
-        animation->start(QAbstractAnimation::DeleteWhenStopped);
-        });
+    scrollTarget_ = content;
+    queueScrollToTarget_();
 }
 
 void View::eotAdjust_(Element* element)
@@ -383,57 +869,172 @@ void View::eotAdjust_(Element* element)
     element->setEot(Eot::hasTerminalPunct(speech));
 }
 
-LoadPlan View::parse_(const QJsonDocument& document)
+LoadPlan View::parse_(const QByteArray& json)
 {
-    LoadPlan plan{};
+    // Straight from the file's bytes (no QJsonDocument in between)
+    TRACE_SPAN("View::parse_");
+    return LoadPlan::fromJson(json);
+}
 
-    if (document.isObject())
-    {
-        auto root = document.object();
+QByteArray View::compile_() const
+{
+    // Written by hand, laid out like QJsonDocument::Indented, so fields we
+    // don't use go back out as the same bytes they came in as. Ours come
+    // first, in the order QJsonObject would sort them
+    TRACE_SPAN("View::compile_");
+    QByteArray out{};
+    out.reserve(source_.size());
+
+    // Extra fields start with their quoted key
+    auto is_member = [](QByteArrayView span, const char* key)
+        {
+            auto length = static_cast<qsizetype>(std::strlen(key));
 
-        if (!root.contains(Keys::RESULTS_ARRAY))
-            return plan;
+            return span.size() > length + 1
+                && span.at(0) == '"'
+                && span.at(length + 1) == '"'
+                && std::memcmp(span.data() + 1, key, length) == 0;
+        };
+
+    auto has_member = [&](LoadPlan::ExtraFields extras, const char* key)
+        {
+            for (auto i = extras.first; i < extras.first + extras.count; ++i)
+                if (is_member(extraSpans_.at(i), key))
+                    return true;
+
+            return false;
+        };
+
+    // Members named in skip are left out (when we've written our own).
+    // beginMember writes whatever goes before each one
+    auto append_extras = [&](LoadPlan::ExtraFields extras, auto beginMember, const QList<const char*>& skip = {})
+        {
+            for (auto i = extras.first; i < extras.first + extras.count; ++i)
+            {
+                const auto& span = extraSpans_.at(i);
+
+                if (std::any_of(skip.cbegin(), skip.cend(), [&](const char* key) { return is_member(span, key); }))
+                    continue;
+
+                beginMember();
+                out.append(span);
+            }
+        };
+
+    out += "{\n    \"";
+    out += Keys::RESULTS_ARRAY;
+    out += "\": [";
+
+    auto first = true;
+
+    for (auto& element : elements_)
+    {
+        out += first ? "\n        {\n" : ",\n        {\n";
+        first = false;
+
+        // A Role, Content or EndOfTurn of the wrong type in the file is kept
+        // as an extra field, and left as it was unless it's been set since
+        auto extras = element->extraFields();
+        auto speech = element->speech();
+        auto role = element->role();
+        QList<const char*> replaced{};
+        auto members = 0;
+
+        auto begin_member = [&]
+            {
+                out += (members++ > 0) ? ",\n            " : "            ";
+            };
 
-        // Check if the value at the "results" key is an array
-        if (!root[Keys::RESULTS_ARRAY].isArray())
-            return plan;
+        auto begin_own = [&](const char* key)
+            {
+                begin_member();
+                out += '"';
+                out += key;
+                out += "\": ";
+                replaced << key;
+            };
 
-        // Check for erroneous keys, etc? Would need to set to null?
+        if (!speech.isEmpty() || !has_member(extras, Keys::SPEECH))
+        {
+            begin_own(Keys::SPEECH);
+            appendJsonString_(out, speech);
+        }
 
-        auto array = root[Keys::RESULTS_ARRAY].toArray();
+        if (element->eot() || !has_member(extras, Keys::EOT))
+        {
+            begin_own(Keys::EOT);
+            out += element->eot() ? "true" : "false";
+        }
 
-        for (const auto& value : array)
+        if (!role.isEmpty() || !has_member(extras, Keys::ROLE))
         {
-            if (!value.isObject()) continue;
-            plan.add(value);
+            begin_own(Keys::ROLE);
+            appendJsonString_(out, role);
         }
+
+        append_extras(extras, begin_member, replaced);
+        out += "\n        }";
     }
 
-    return plan;
+    out += elements_.isEmpty() ? "]" : "\n    ]";
+    append_extras(topLevelExtraFields_, [&] { out += ",\n    "; });
+    out += "\n}\n";
+
+    return out;
 }
 
-QJsonDocument View::compile_()
+bool View::eventFilter(QObject* watched, QEvent* event)
 {
-    QJsonObject root{};
-    QJsonArray array{};
-
-    for (auto& element : elements_)
+    if (watched == contentContainer_)
     {
-        QJsonObject object{};
-
-        object[Keys::ROLE] = element->role();
-        object[Keys::SPEECH] = element->speech();
-        object[Keys::EOT] = element->eot();
-
-        array << object;
+        switch (event->type())
+        {
+        default: break;
+
+        case QEvent::MouseMove:
+            updateInsertButton_(static_cast<QMouseEvent*>(event)->position().toPoint().y());
+            break;
+
+        // Entering the insert button (a child) doesn't count as leaving
+        case QEvent::Leave:
+            insertButton_->hide();
+            break;
+
+        // Late height changes (like an AutoSizeTextEdit settling on its final
+        // width) can move the target while we're scrolling, so follow it
+        case QEvent::Resize:
+            if (scrollTarget_) queueScrollToTarget_();
+            updateMinimapViewport_();
+            if (!reflowQueue_.isEmpty()) queueReflow_();
+            break;
+        }
+    }
+    else if (event->type() == QEvent::Enter && qobject_cast<Element*>(watched))
+    {
+        // The container doesn't get mouse moves once the pointer is over an
+        // element, so it can't hide the button itself
+        insertButton_->hide();
     }
 
-    root[Keys::RESULTS_ARRAY] = array;
-    return QJsonDocument(root);
+    return QWidget::eventFilter(watched, event);
 }
 
 void View::connectElement_(Element* element)
 {
+    element->installEventFilter(this);
+
+    connect
+    (
+        element->speechEdit(),
+        &AutoSizeTextEdit::reflowDeferred,
+        this,
+        [this, element]
+        {
+            reflowQueue_ << element;
+            queueReflow_();
+        }
+    );
+
     connect
     (
         element,
@@ -488,6 +1089,21 @@ void View::connectElement_(Element* element)
         &View::onSpeechEditMouseChorded_
     );
 
+    connect
+    (
+        element->speechEdit(),
+        &AutoSizeTextEdit::insertRequested,
+        this,
+        [this, element]
+        {
+            auto index = elements_.indexOf(element);
+            if (index < 0) return;
+
+            auto element_index = insertElement_(index + 1);
+            scrollToContent_(elements_.at(element_index));
+        }
+    );
+
     connect
     (
         element,
@@ -495,91 +1111,326 @@ void View::connectElement_(Element* element)
         this,
         &View::onElementDeleteRequested_
     );
-}
-
-void View::insertInsertButton_(int position)
-{
-    auto button_container = new QWidget(contentContainer_);
-
-    auto container_layout = Coco::Layout::make<QHBoxLayout>
-        (
-            { 1, 6, 1, 6 }, 0,
-            button_container,
-            Qt::AlignCenter
-        );
-
-    auto button = new InsertButton(position, button_container);
-    insertButtons_.insert(position, button);
-
-    container_layout->addWidget(button);
-
-    button->setText("+");
-    button->setFixedSize(25, 25);
 
     connect
     (
-        button,
-        &InsertButton::insertRequested,
+        element,
+        &Element::speechChanged,
         this,
-        [&](int pos)
+        &View::onElementSpeechChanged_
+    );
+
+    connect
+    (
+        element,
+        &Element::roleChanged,
+        this,
+        &View::onElementRoleChanged_
+    );
+
+    connect
+    (
+        element,
+        &Element::eotChanged,
+        this,
+        &View::onElementEotChanged_
+    );
+}
+
+int View::gapAt_(int y) const
+{
+    // Shown elements are laid out top to bottom, so binary search for the
+    // first one starting below y. The gap we're in (if any) comes right
+    // before it
+    const auto& shown = shown_();
+    auto low = 0;
+    auto high = static_cast<int>(shown.count());
+
+    while (low < high)
+    {
+        auto mid = (low + high) / 2;
+
+        if (shown.at(mid)->geometry().top() > y)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    // Pointer is beside an element, not between two
+    if (low > 0 && shown.at(low - 1)->geometry().bottom() >= y)
+        return -1;
+
+    return low;
+}
+
+int View::gapPosition_(int gap) const
+{
+    // Maps a gap between shown elements to a position in elements_. New
+    // elements go right after the shown element above the gap, even if
+    // hidden ones follow it (without a filter, this is just the gap)
+    const auto& shown = shown_();
+
+    if (gap > 0)
+        return static_cast<int>(elements_.indexOf(shown.at(gap - 1))) + 1;
+
+    return shown.isEmpty()
+        ? static_cast<int>(elements_.count())
+        : static_cast<int>(elements_.indexOf(shown.first()));
+}
+
+void View::updateInsertButton_(int y)
+{
+    auto gap = gapAt_(y);
+
+    if (gap < 0)
+    {
+        insertButton_->hide();
+        return;
+    }
+
+    const auto& shown = shown_();
+
+    auto gap_top = (gap > 0)
+        ? shown.at(gap - 1)->geometry().bottom() + 1
+        : 0;
+
+    // The last gap is open-ended (the container can be taller than its
+    // content), so cap it
+    auto gap_bottom = (gap < shown.count())
+        ? shown.at(gap)->geometry().top()
+        : gap_top + GAP_;
+
+    insertButton_->setPosition(gapPosition_(gap));
+    insertButton_->move
+    (
+        (contentContainer_->width() - insertButton_->width()) / 2,
+        gap_top + ((gap_bottom - gap_top - insertButton_->height()) / 2)
+    );
+
+    insertButton_->show();
+    insertButton_->raise();
+}
+
+void View::rebuildSearchIndex_(const LoadPlan& plan)
+{
+    // Index from the plan (which elements_ was just built from, in the same
+    // order) on another thread. Results from an older document are dropped
+    auto generation = ++searchGeneration_;
+    searchIndexReady_ = false;
+    searchDirty_.clear();
+
+    auto watcher = new QFutureWatcher<SearchIndex>(this);
+
+    connect
+    (
+        watcher,
+        &QFutureWatcher<SearchIndex>::finished,
+        this,
+        [this, watcher, generation]
         {
-            // Need to fix element vs content vs button index :(((((
-            auto element_index = insertElement_(pos);
-            scrollToContent_(((element_index * 2) + 1) + 1); // Include the button
+            watcher->deleteLater();
+            if (generation != searchGeneration_) return;
+
+            searchIndex_ = watcher->result();
+            searchIndexReady_ = true;
+
+            if (searchBar_->isVisible())
+                onSearchQueryChanged_(searchBar_->query());
         }
     );
 
-    // Button at position n goes at layout index n * 2
-    contentLayout_->insertWidget((position * 2), button_container);
+    watcher->setFuture
+    (
+        QtConcurrent::run
+        (
+            [keys = elements_.toList(), plan]
+            {
+                TRACE_SPAN("View::rebuildSearchIndex_ (worker)");
+                SearchIndex index{};
+
+                for (auto i = 0; i < keys.count() && i < plan.count(); ++i)
+                    index.set(keys.at(i), plan.role(i), plan.speech(i));
+
+                return index;
+            }
+        )
+    );
+}
+
+void View::flushSearchIndex_()
+{
+    if (!searchIndexReady_) return;
+
+    // Dirty elements that were deleted since are no longer in elements_
+    for (auto& element : std::as_const(searchDirty_))
+    {
+        if (elements_.contains(element))
+            searchIndex_.set(element, element->role(), element->speech());
+        else
+            searchIndex_.remove(element);
+    }
+
+    searchDirty_.clear();
+}
+
+void View::goToSearchHit_(int index)
+{
+    if (searchHits_.isEmpty()) return;
+
+    // Wrap around
+    auto count = static_cast<int>(searchHits_.count());
+    index = ((index % count) + count) % count;
+    searchHitIndex_ = index;
+    searchBar_->setResult(index, count);
+
+    auto element = searchHits_.at(index);
+    if (!element) return;
+
+    scrollToContent_(element);
+
+    // Select the first word of the query, without taking focus from the
+    // search bar
+    auto words = SearchIndex::tokenize(searchBar_->query());
+    if (words.isEmpty()) return;
+
+    auto edit = element->speechEdit();
+    auto match = edit->document()->find(words.first());
+    if (!match.isNull()) edit->setTextCursor(match);
+}
+
+QStringList View::speeches_() const
+{
+    QStringList speeches{};
+    speeches.reserve(elements_.count());
+
+    for (auto& element : elements_)
+        speeches << element->speech();
+
+    return speeches;
+}
+
+QList<LoadPlan::Item> View::items_() const
+{
+    QList<LoadPlan::Item> items{};
+    items.reserve(elements_.count());
+
+    for (auto& element : elements_)
+        items << LoadPlan::Item{ element->role(), element->speech(), element->eot() };
+
+    return items;
+}
+
+int View::shownIndexAt_(int y) const
+{
+    // First shown element that ends at or below y (or the shown count, if
+    // there aren't any)
+    const auto& shown = shown_();
+    auto low = 0;
+    auto high = static_cast<int>(shown.count());
+
+    while (low < high)
+    {
+        auto mid = (low + high) / 2;
+
+        if (shown.at(mid)->geometry().bottom() < y)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+void View::resetMinimap_()
+{
+    minimapStale_ = false;
+
+    QHash<QString, int> role_indexes{};
+
+    for (auto i = 0; i < roleChoices_.count(); ++i)
+        role_indexes[roleChoices_.at(i)] = i;
+
+    QList<int> turns{};
+    turns.reserve(elements_.count());
+
+    for (auto& element : elements_)
+        turns << role_indexes.value(element->role(), -1);
+
+    minimap_->setColors(Coco::Fx::goldenRatioColors(roleChoices_.count()));
+    minimap_->setTurns(turns);
+    updateMinimapViewport_();
+}
+
+void View::reflowVisible_()
+{
+    if (reflowQueue_.isEmpty()) return;
+
+    const auto& shown = shown_();
+    auto top = scrollArea_->verticalScrollBar()->value();
+    auto first = shownIndexAt_(top);
+    auto last = shownIndexAt_(top + scrollArea_->viewport()->height());
+
+    for (auto i = first; i <= last && i < shown.count(); ++i)
+    {
+        auto element = shown.at(i);
+        if (!reflowQueue_.remove(element)) continue;
+
+        element->speechEdit()->reflow();
+    }
+}
+
+void View::jumpTo_(Element* element)
+{
+    // Immediate, unlike scrollToContent_, so the minimap can be dragged
+    if (!element || element->isHidden()) return;
+
+    scrollAnimation_->stop();
+    scrollTarget_ = nullptr;
+    scrollArea_->verticalScrollBar()->setValue(element->geometry().top() - (GAP_ / 2));
 }
 
 void View::populate_(const LoadPlan& plan)
 {
+    TRACE_SPAN("View::populate_");
+    Transaction transaction(this);
     roleChoices_ = plan.roles();
+    filterBar_->setRoles(roleChoices_);
 
-    // Add the first insert button before any elements
-    insertInsertButton_(0);
+    source_ = plan.source();
+    extraSpans_ = plan.extraSpans();
+    topLevelExtraFields_ = plan.topLevelExtraFields();
 
-    for (int i = 0; i < plan.items().count(); ++i)
+    for (auto i = 0; i < plan.count(); ++i)
     {
-        const auto& item = plan.items().at(i);
+        // Speech goes from the plan's arena into the document with no copy
+        // in between. (Stats only count words, so they don't keep it)
+        const auto& role = plan.role(i);
+        auto speech = plan.borrowSpeech(i);
+        auto eot = plan.eot(i);
 
         auto element = new Element(contentContainer_);
         elements_ << element;
 
         element->setRoleChoices(roleChoices_);
 
-        element->setRole(item.role);
-        element->setSpeech(item.speech);
-        element->setEot(item.eot);
+        element->setRole(role);
+        element->setSpeech(speech);
+        ++LoadPlan::counters().textCopies;
+        element->setEot(eot);
+        element->setExtraFields(plan.extraFields(i));
 
-        // Element goes at layout position (i * 2) + 1
         contentLayout_->addWidget(element);
         connectElement_(element);
-
-        // Add insert button after this element
-        insertInsertButton_(i + 1);
+        stats_.set(element, role, speech, eot);
     }
 }
 
 // Does not return a content index!
-int View::insertElement_(int position, const LoadPlan::Item item)
+int View::insertElement_(int position, LoadPlan::Item item)
 {
-    auto element = new Element(contentContainer_);
-    elements_.insert(position, element);
-    element->setRoleChoices(roleChoices_);
-
-    element->setRole(item.role);
-    element->setSpeech(item.speech);
-    element->setEot(item.eot);
-
-    auto element_layout_index = (position * 2) + 1;
-
-    contentLayout_->insertWidget(element_layout_index, element);
-    connectElement_(element);
-
-    insertInsertButton_(position + 1);
-    updateInsertButtonPositions_(position + 1);
+    QList<LoadPlan::Item> items{};
+    items << std::move(item);
+    auto element = insertElements_(position, std::move(items)).first();
 
     // Focus new element
     auto new_speech_edit = element->speechEdit();
@@ -591,38 +1442,466 @@ int View::insertElement_(int position, const LoadPlan::Item item)
     return elements_.indexOf(element);
 }
 
+// Inserts items in order, starting at position, in one layout pass.
+// Doesn't focus anything
+QList<Element*> View::insertElements_(int position, QList<LoadPlan::Item> items)
+{
+    Transaction transaction(this);
+    QList<Element*> inserted{};
+    inserted.reserve(items.count());
+
+    for (auto i = 0; i < items.count(); ++i)
+    {
+        const auto& item = items.at(i);
+        auto at = position + i;
+
+        auto element = new Element(contentContainer_);
+        elements_.insert(at, element);
+        element->setRoleChoices(roleChoices_);
+
+        element->setRole(item.role);
+        element->setSpeech(item.speech);
+        element->setEot(item.eot);
+        element->setExtraFields(item.extraFields);
+
+        contentLayout_->insertWidget(at, element);
+        connectElement_(element);
+        searchDirty_ << element;
+        stats_.set(element, item.role, item.speech, item.eot);
+
+        // One at a time, the minimap can just make room. Any more and it's
+        // cheaper to redraw it once at the end
+        if (items.count() == 1)
+            minimap_->insertTurn(at, roleIndex_(item.role));
+        else
+            minimapStale_ = true;
+
+        // New elements are always shown, filter or not. Shown elements are
+        // in document order, so find where this one falls among them
+        if (filterActive_)
+        {
+            auto low = 0;
+            auto high = static_cast<int>(filtered_.count());
+
+            while (low < high)
+            {
+                auto mid = (low + high) / 2;
+
+                if (elements_.indexOf(filtered_.at(mid)) < at)
+                    low = mid + 1;
+                else
+                    high = mid;
+            }
+
+            filtered_.insert(low, element);
+        }
+
+        inserted << element;
+    }
+
+    queueStatsRefresh_();
+    return inserted;
+}
+
+void View::removeElement_(Element* element)
+{
+    auto index = elements_.indexOf(element);
+    if (index < 0) return;
+
+    elements_.removeAt(index);
+    filtered_.removeOne(element);
+    searchDirty_ << element;
+    stats_.remove(element);
+    queueStatsRefresh_();
+    reflowQueue_.remove(element);
+
+    if (transactionDepth_ > 0)
+        minimapStale_ = true;
+    else
+        minimap_->removeTurn(index);
+
+    removeContent_(static_cast<int>(index));
+}
+
+void View::onSearchQueryChanged_(const QString& query)
+{
+    searchHits_.clear();
+    searchHitIndex_ = -1;
+
+    // Still building. This is called again once the index is ready
+    if (!searchIndexReady_)
+    {
+        searchBar_->setResult(-1, 0);
+        return;
+    }
+
+    flushSearchIndex_();
+
+    for (auto& hit : searchIndex_.search(query))
+        searchHits_ << const_cast<Element*>(hit.key);
+
+    searchBar_->setResult(-1, searchHits_.count());
+    goToSearchHit_(0);
+}
+
+void View::previewReplace_()
+{
+    // Older previews still running are ignored when they finish
+    auto generation = ++replacePreviewGeneration_;
+    auto options = replaceBar_->options();
+
+    if (options.find.isEmpty())
+    {
+        replaceBar_->setPreview({});
+        return;
+    }
+
+    auto regex = Replace::toRegex(options);
+
+    if (!regex.isValid())
+    {
+        replaceBar_->setPreview(regex.errorString());
+        return;
+    }
+
+    replaceBar_->setPreview("Counting...");
+
+    auto watcher = new QFutureWatcher<int>(this);
+
+    connect
+    (
+        watcher,
+        &QFutureWatcher<int>::finished,
+        this,
+        [this, watcher, generation]
+        {
+            watcher->deleteLater();
+            if (generation != replacePreviewGeneration_) return;
+
+            auto matches = 0;
+            auto turns = 0;
+
+            for (auto count : watcher->future().results())
+            {
+                if (count < 1) continue;
+                matches += count;
+                ++turns;
+            }
+
+            replaceBar_->setPreview
+            (
+                QString("%1 matches in %2 turns").arg(matches).arg(turns)
+            );
+        }
+    );
+
+    watcher->setFuture
+    (
+        QtConcurrent::mapped
+        (
+            speeches_(),
+            [options, regex](const QString& speech)
+            {
+                return Replace::count(speech, options, regex);
+            }
+        )
+    );
+}
+
+void View::replaceAll_()
+{
+    auto options = replaceBar_->options();
+    if (options.find.isEmpty()) return;
+
+    auto regex = Replace::toRegex(options);
+    if (!regex.isValid()) return;
+
+    if (currentEdit_) currentEdit_->simplify();
+
+    // Matching happens off the GUI thread. Replacements are only applied to
+    // elements whose speech hasn't changed since the snapshot
+    auto elements = elements_.toList();
+    auto speeches = speeches_();
+    ++replacePreviewGeneration_;
+    replaceBar_->setPreview("Replacing...");
+
+    auto watcher = new QFutureWatcher<Replace::Result>(this);
+
+    connect
+    (
+        watcher,
+        &QFutureWatcher<Replace::Result>::finished,
+        this,
+        [this, watcher, elements, speeches]
+        {
+            watcher->deleteLater();
+
+            auto results = watcher->future().results();
+            auto matches = 0;
+            QList<std::pair<QPointer<Element>, QString>> undo{};
+
+            Transaction transaction(this);
+
+            for (auto i = 0; i < results.count() && i < elements.count(); ++i)
+            {
+                const auto& result = results.at(i);
+                if (result.matches < 1) continue;
+
+                auto element = elements.at(i);
+                if (!elements_.contains(element)) continue;
+                if (element->speech() != speeches.at(i)) continue;
+
+                undo.append({ element, speeches.at(i) });
+                element->setSpeech(result.speech);
+                matches += result.matches;
+            }
+
+            // Replacing nothing shouldn't wipe out the last undo (counted
+            // first, since it's moved from)
+            auto turns = undo.count();
+
+            if (!undo.isEmpty())
+            {
+                replaceUndo_ = std::move(undo);
+                replaceBar_->setUndoEnabled(true);
+            }
+
+            replaceBar_->setPreview
+            (
+                QString("Replaced %1 matches in %2 turns").arg(matches).arg(turns)
+            );
+        }
+    );
+
+    watcher->setFuture
+    (
+        QtConcurrent::mapped
+        (
+            speeches,
+            [options, regex](const QString& speech)
+            {
+                return Replace::apply(speech, options, regex);
+            }
+        )
+    );
+}
+
+void View::undoReplace_()
+{
+    Transaction transaction(this);
+
+    for (auto& [element, speech] : replaceUndo_)
+        if (element && elements_.contains(element))
+            element->setSpeech(speech);
+
+    replaceUndo_.clear();
+    replaceBar_->setUndoEnabled(false);
+    previewReplace_();
+}
+
+void View::applyFilter_()
+{
+    // Matching runs on a snapshot of the turn data, in parallel. Widgets
+    // are only shown or hidden (never rebuilt), and only if they change
+    auto filter = filterBar_->filter();
+    auto was_active = filterActive_;
+    filterActive_ = !filter.isNull();
+    filtered_.clear();
+    insertButton_->hide();
+
+    // Nothing is hidden, and nothing should be
+    if (!was_active && !filterActive_) return;
+
+    QList<bool> matches{};
+
+    if (filterActive_)
+    {
+        matches = QtConcurrent::blockingMapped<QList<bool>>
+        (
+            items_(),
+            [filter](const LoadPlan::Item& item) { return filter.matches(item); }
+        );
+    }
+
+    Transaction transaction(this);
+    auto i = 0;
+
+    for (auto& element : elements_)
+    {
+        auto match = !filterActive_ || matches.at(i++);
+        if (filterActive_ && match) filtered_ << element;
+        // (Elements in a container that hasn't been shown yet aren't
+        // hidden, they just aren't visible)
+        if (element->isVisibleTo(contentContainer_) != match)
+            element->setVisible(match);
+    }
+}
+
+void View::scrollToTarget_()
+{
+    scrollQueued_ = false;
+    if (!scrollTarget_) return;
+
+    auto scroll_bar = scrollArea_->verticalScrollBar();
+    if (!scroll_bar) return;
+
+    // Filtered out
+    if (scrollTarget_->isHidden())
+    {
+        scrollTarget_ = nullptr;
+        return;
+    }
+
+    // Apply any pending layout now, so the target's geometry is final. We
+    // don't wait on the scroll area to resize the container, since we can
+    // get the content height from the layout ourselves
+    contentLayout_->activate();
+
+    auto geometry = scrollTarget_->geometry();
+    auto viewport_height = scrollArea_->viewport()->height();
+    auto content_height = qMax
+    (
+        contentLayout_->sizeHint().height(),
+        contentContainer_->height()
+    );
+
+    // Don't scroll if the target is already visible (compare against where
+    // we're headed, if we're already moving)
+    auto top = (scrollAnimation_->state() == QAbstractAnimation::Running)
+        ? scrollAnimation_->endValue().toInt()
+        : scroll_bar->value();
+
+    if (geometry.top() >= top && geometry.bottom() < top + viewport_height)
+    {
+        if (scrollAnimation_->state() != QAbstractAnimation::Running)
+            scrollTarget_ = nullptr;
+
+        return;
+    }
+
+    auto to = geometry.bottom() + 1 - viewport_height;
+    to = qBound(0, to, qMax(0, content_height - viewport_height));
+
+    scrollAnimation_->stop();
+    scrollAnimation_->setStartValue(scroll_bar->value());
+    scrollAnimation_->setEndValue(to);
+    scrollAnimation_->start();
+}
+
+void View::reflowSlice_()
+{
+    reflowQueued_ = false;
+    reflowVisible_();
+    if (reflowQueue_.isEmpty()) return;
+
+    // Elements above the viewport changing height would push the content
+    // around, so note where the top one is and put it back afterward
+    auto scroll_bar = scrollArea_->verticalScrollBar();
+    auto top = scroll_bar->value();
+    auto top_index = shownIndexAt_(top);
+
+    QPointer<Element> anchor = (top_index < shown_().count())
+        ? shown_().at(top_index)
+        : nullptr;
+
+    auto anchor_offset = anchor ? anchor->y() - top : 0;
+
+    {
+        Transaction transaction(this);
+        auto it = reflowQueue_.begin();
+
+        for (auto i = 0; i < REFLOW_SLICE_ && it != reflowQueue_.end(); ++i)
+        {
+            auto element = *it;
+            it = reflowQueue_.erase(it);
+            element->speechEdit()->reflow();
+        }
+    }
+
+    // The scroll range is updated once the scroll area handles the layout
+    // request, which was posted before this
+    QTimer::singleShot(0, this, [this, anchor, anchor_offset]
+        {
+            if (!anchor || scrollTarget_) return;
+            if (scrollAnimation_->state() == QAbstractAnimation::Running) return;
+
+            scrollArea_->verticalScrollBar()->setValue(anchor->y() - anchor_offset);
+        });
+
+    if (!reflowQueue_.isEmpty()) queueReflow_();
+}
+
+void View::teardownSlice_()
+{
+    // Deleting thousands of widgets at once freezes the window, so delete a
+    // slice of them whenever the event loop is free until they're all gone.
+    // Taking from the front is cheap for both the layout and the container's
+    // child list
+    teardownQueued_ = false;
+
+    while (!discardedContainers_.isEmpty() && !discardedContainers_.first())
+        discardedContainers_.removeFirst();
+
+    if (discardedContainers_.isEmpty()) return;
+
+    QWidget* container = discardedContainers_.first();
+    auto layout = container->layout();
+
+    for (auto i = 0; i < TEARDOWN_SLICE_; ++i)
+    {
+        auto item = layout ? layout->takeAt(0) : nullptr;
+
+        if (!item)
+        {
+            discardedContainers_.removeFirst();
+            delete container;
+            break;
+        }
+
+        deleteItemWidget_(item);
+    }
+
+    if (!discardedContainers_.isEmpty())
+    {
+        teardownQueued_ = true;
+        QTimer::singleShot(0, this, &View::teardownSlice_);
+    }
+}
+
 void View::onElementRoleChangeRequested_(const QString& from, const QString& to)
 {
+    TRACE_SPAN("View::onElementRoleChangeRequested_");
     roleChoices_.removeAll(from);
     roleChoices_ << to;
     Coco::Utility::sort(roleChoices_);
+    filterBar_->setRoles(roleChoices_);
 
-    for (auto i = 0; i < elements_.count(); ++i)
+    Transaction transaction(this);
+
+    for (auto& element : elements_)
     {
-        if (auto element = elements_.at(i))
-        {
-            // Recall current selection
-            auto current = element->role();
-            element->setRoleChoices(roleChoices_);
-            element->setRole((current == from) ? to : current);
-        }
+        // Recall current selection
+        auto current = element->role();
+        element->setRoleChoices(roleChoices_);
+        element->setRole((current == from) ? to : current);
     }
 }
 
 void View::onElementRoleAddRequested_(const QString& role)
 {
+    TRACE_SPAN("View::onElementRoleAddRequested_");
     roleChoices_ << role;
     Coco::Utility::sort(roleChoices_);
+    filterBar_->setRoles(roleChoices_);
+
+    Transaction transaction(this);
 
-    for (auto i = 0; i < elements_.count(); ++i)
+    for (auto& element : elements_)
     {
-        if (auto element = elements_.at(i))
-        {
-            // Recall current selection
-            auto current = element->role();
-            element->setRoleChoices(roleChoices_);
-            element->setRole(current);
-        }
+        // Recall current selection
+        auto current = element->role();
+        element->setRoleChoices(roleChoices_);
+        element->setRole(current);
     }
 }
 
@@ -643,25 +1922,7 @@ void View::onQAppFocusChanged_(QWidget* old, QWidget* now)
 
 void View::onElementDeleteRequested_(Element* element)
 {
-    auto index = elements_.indexOf(element);
-    if (index < 0) return;
-
-    elements_.removeAt(index);
-
-    auto element_layout_index = (index * 2) + 1;
-    auto insert_button_layout_index = (index + 1) * 2;
-
-    // Remove the element widget from layout
-    removeContent_(element_layout_index);
-
-    // Remove the trailing insert button from list
-    insertButtons_.removeAt(index + 1);
-
-    // Remove the trailing insert button widget from layout
-    removeContent_(insert_button_layout_index - 1); // -1 because we already removed one item
-
-    // Update positions of all subsequent insert buttons
-    updateInsertButtonPositions_(index + 1);
+    removeElement_(element);
 }
 
 // Revise (duh). We may want just a key to combo (alt + something/else) to
@@ -695,3 +1956,52 @@ void View::onSpeechEditMouseChorded_(int key, Qt::KeyboardModifiers modifiers) /
     auto max = roleChoices_.count() - 1;
     split(true, qBound(0, i, max));
 }
+
+void View::onElementSpeechChanged_(Element* element)
+{
+    searchDirty_ << element;
+    stats_.setSpeech(element, element->speech());
+    queueStatsRefresh_();
+}
+
+void View::onElementRoleChanged_(Element* element)
+{
+    searchDirty_ << element;
+    stats_.setRole(element, element->role());
+    queueStatsRefresh_();
+
+    if (transactionDepth_ > 0)
+        minimapStale_ = true;
+    else
+        minimap_->setTurn(elements_.indexOf(element), roleIndex_(element->role()));
+}
+
+void View::onElementEotChanged_(Element* element)
+{
+    stats_.setEot(element, element->eot());
+    queueStatsRefresh_();
+}
+
+void View::updateMinimapViewport_()
+{
+    // In elements_ terms (the minimap shows everything, filtered or not)
+    const auto& shown = shown_();
+    if (shown.isEmpty()) return;
+
+    auto top = scrollArea_->verticalScrollBar()->value();
+    auto first = shownIndexAt_(top);
+    auto last = shownIndexAt_(top + scrollArea_->viewport()->height());
+    last = qMin(last, static_cast<int>(shown.count()) - 1);
+
+    if (first >= shown.count())
+    {
+        minimap_->setVisibleTurns(-1, -1);
+        return;
+    }
+
+    minimap_->setVisibleTurns
+    (
+        static_cast<int>(elements_.indexOf(shown.at(first))),
+        static_cast<int>(elements_.indexOf(shown.at(last)))
+    );
+}
@@ -1,12 +1,21 @@
 #pragma once
 
-#include <QJsonDocument>
+#include <utility>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QEvent>
 #include <QLayoutItem>
 #include <QList>
+#include <QMetaObject>
 #include <QObject>
 #include <QPointer>
+#include <QPropertyAnimation>
 #include <QScrollArea>
+#include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 #include <QtTypes>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -15,26 +24,68 @@
 
 #include "AutoSizeTextEdit.h"
 #include "Element.h"
+#include "FilterBar.h"
+#include "IndexedList.h"
 #include "InsertButton.h"
 #include "LoadPlan.h"
+#include "Minimap.h"
+#include "ReplaceBar.h"
+#include "RoleStats.h"
+#include "SearchBar.h"
+#include "SearchIndex.h"
+#include "StatsPanel.h"
+#include "Trace.h"
 
 // Rename element_layout vars (and etc.) to content_layout or content
 
-// Could do contentIndex overload for buttons and elements, returning correct
-// position based on type
 class View : public QWidget
 {
     Q_OBJECT
 
+    // Times private stages (parse_, populate_) and drives split directly
+    friend class Bench;
+
 public:
+    // Holds off painting and layout of the content for as long as it lives,
+    // then lays out and repaints once. Anything touching more than one
+    // element should open one of these. They can be nested
+    class Transaction
+    {
+    public:
+        explicit Transaction(View* view) : view_(view) { view_->beginTransaction_(); }
+        ~Transaction() { view_->commitTransaction_(); }
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+    private:
+        View* view_;
+    };
+
+    // What the performance HUD shows (see PerfHud). Timings are -1 until
+    // the first one
+    struct Metrics
+    {
+        qsizetype elements = 0;
+        qsizetype shown = 0;
+        qsizetype textCharacters = 0;
+        double lastLoadMs = -1.0;
+        double lastSaveMs = -1.0;
+        double lastSplitMs = -1.0;
+    };
+
     explicit View(QWidget* parent = nullptr);
     virtual ~View() override;
 
     void autoEot()
     {
+        TRACE_SPAN("View::autoEot");
+
         if (currentEdit_)
             currentEdit_->simplify();
 
+        Transaction transaction(this);
+
         for (auto& element : elements_)
             eotAdjust_(element);
     }
@@ -42,31 +93,181 @@ public:
     bool load(const Coco::Path& path);
     bool save();
     void split(bool forceTripart = false, int tripartRole = -1);
+    void merge();
+    void mergeAll();
+    void splitLongTurns(int maxLength = 500);
+    void find() { searchBar_->activate(); }
+    void findReplace() { replaceBar_->activate(); }
+    void filter() { filterBar_->activate(); }
+
+    Metrics metrics() const;
+
+    void showStats()
+    {
+        statsPanel_->show();
+        statsPanel_->raise();
+        statsPanel_->refresh(stats_, roleChoices_);
+    }
 
 signals:
     void documentLoaded();
 
+protected:
+    virtual bool eventFilter(QObject* watched, QEvent* event) override;
+
 private:
     QVBoxLayout* mainLayout_ = nullptr;
+    SearchBar* searchBar_ = new SearchBar(this);
+    ReplaceBar* replaceBar_ = new ReplaceBar(this);
+    FilterBar* filterBar_ = new FilterBar(this);
+    StatsPanel* statsPanel_ = new StatsPanel(this);
     QScrollArea* scrollArea_ = new QScrollArea(this);
-    QWidget* contentContainer_ = new QWidget(scrollArea_);
+    Minimap* minimap_ = new Minimap(this);
+    QWidget* contentContainer_ = nullptr;
     QVBoxLayout* contentLayout_ = nullptr;
 
-    QList<Element*> elements_{};
-    QList<InsertButton*> insertButtons_{};
+    // Containers from previous documents, waiting to be torn down a slice at
+    // a time (see teardownSlice_)
+    static constexpr auto TEARDOWN_SLICE_ = 200;
+    QList<QPointer<QWidget>> discardedContainers_{};
+    bool teardownQueued_ = false;
+
+    IndexedList<Element*> elements_{};
     QList<QString> roleChoices_{};
 
     Coco::Path currentPath_{};
     QPointer<AutoSizeTextEdit> currentEdit_{};
 
+    // The loaded file's bytes, kept for the fields we don't use (which
+    // point into them) so save can write those back verbatim. Shared with
+    // the plan, not copied
+    QByteArray source_{};
+    QList<QByteArrayView> extraSpans_{};
+    LoadPlan::ExtraFields topLevelExtraFields_{};
+
+    // There is only ever one scroll animation. New scroll requests retarget
+    // it instead of stacking animations on top of each other
+    QPropertyAnimation* scrollAnimation_ = nullptr;
+    QPointer<QWidget> scrollTarget_{};
+    bool scrollQueued_ = false;
+
+    // A single insert button floats over whichever gap between elements the
+    // pointer is in. Elements are the only things in contentLayout_, so a
+    // layout index is also an element index
+    static constexpr auto GAP_ = 37;
+    InsertButton* insertButton_ = new InsertButton(0, this);
+
+    // The search index is built in the background after loading. Edits
+    // (including those made while it's building) mark elements dirty, and
+    // they're reindexed right before the next search
+    SearchIndex searchIndex_{};
+    QSet<Element*> searchDirty_{};
+    bool searchIndexReady_ = true;
+    int searchGeneration_ = 0;
+    QList<QPointer<Element>> searchHits_{};
+    int searchHitIndex_ = -1;
+
+    // Find-and-replace matches on a snapshot of element speech, off the GUI
+    // thread. Replacing all is undone in one step, from the texts saved here
+    int replacePreviewGeneration_ = 0;
+    QList<std::pair<QPointer<Element>, QString>> replaceUndo_{};
+
+    // While a filter is active, the elements it matches (in document order)
+    // are kept here and the rest are hidden. Anything working with what's
+    // on screen (like the insert button) goes through shown_()
+    bool filterActive_ = false;
+    IndexedList<Element*> filtered_{};
+
+    const IndexedList<Element*>& shown_() const noexcept
+    {
+        return filterActive_ ? filtered_ : elements_;
+    }
+
+    // Updated per element, as elements change. The panel is only refreshed
+    // while it's open, at most once per event loop pass
+    RoleStats stats_{};
+    bool statsRefreshQueued_ = false;
+
+    void queueStatsRefresh_()
+    {
+        if (statsRefreshQueued_ || !statsPanel_->isVisible()) return;
+        statsRefreshQueued_ = true;
+
+        QTimer::singleShot(0, this, [&]
+            {
+                statsRefreshQueued_ = false;
+                statsPanel_->refresh(stats_, roleChoices_);
+            });
+    }
+
+    // Speech edits put off laying out again for a new width while they're
+    // off screen (see AutoSizeTextEdit::reflow). The visible ones are
+    // reflowed right away (and on scroll), the rest a slice at a time when
+    // the event loop is free
+    static constexpr auto REFLOW_SLICE_ = 50;
+    QSet<Element*> reflowQueue_{};
+    bool reflowQueued_ = false;
+
+    void queueReflow_()
+    {
+        if (reflowQueued_) return;
+        reflowQueued_ = true;
+        QTimer::singleShot(0, this, &View::reflowSlice_);
+    }
+
+    double lastLoadMs_ = -1.0;
+    double lastSaveMs_ = -1.0;
+    double lastSplitMs_ = -1.0;
+
     // Click is a press & release
     bool ignoreNextSpeechEditMClick_ = false;
 
-    void updateInsertButtonPositions_(int startPosition)
+    int transactionDepth_ = 0;
+
+    // Set when roles change during a transaction (e.g. a role rename), so
+    // the minimap is redrawn once at the end instead of per element
+    bool minimapStale_ = false;
+
+    void beginTransaction_()
     {
-        // Update positions for all buttons from startPosition onward
-        for (auto i = startPosition; i < insertButtons_.size(); ++i)
-            insertButtons_[i]->setPosition(i);
+        if (transactionDepth_++ > 0) return;
+
+        contentContainer_->setUpdatesEnabled(false);
+        contentLayout_->setEnabled(false);
+    }
+
+    void commitTransaction_()
+    {
+        if (--transactionDepth_ > 0) return;
+
+        // Layout requests posted in the meantime will find the layout
+        // already activated and do nothing. Re-enabling updates schedules
+        // the repaint
+        contentLayout_->setEnabled(true);
+        contentLayout_->activate();
+        contentContainer_->setUpdatesEnabled(true);
+
+        if (minimapStale_) resetMinimap_();
+    }
+
+    int roleIndex_(const QString& role) const
+    {
+        return static_cast<int>(roleChoices_.indexOf(role));
+    }
+
+    void queueScrollToTarget_()
+    {
+        // Posted events are handled in order, so by the time this runs, any
+        // widgets inserted beforehand have been shown and can be laid out
+        if (scrollQueued_) return;
+        scrollQueued_ = true;
+
+        QMetaObject::invokeMethod
+        (
+            this,
+            &View::scrollToTarget_,
+            Qt::QueuedConnection
+        );
     }
 
     void deleteItemWidget_(QLayoutItem* item)
@@ -83,28 +284,49 @@ private:
             deleteItemWidget_(item);
     }
 
-    void clearAllContent_()
-    {
-        QLayoutItem* item = nullptr;
-
-        while ((item = contentLayout_->takeAt(0)) != nullptr)
-            deleteItemWidget_(item);
-    }
-
     void initialize_();
-    void scrollToContent_(int contentIndex);
+    QWidget* makeContentContainer_();
+    void setContentContainer_(QWidget* container);
+    void discardContentContainer_(QWidget* container);
+    void scrollToContent_(QWidget* content);
     void eotAdjust_(Element* element);
-    LoadPlan parse_(const QJsonDocument& document);
-    QJsonDocument compile_();
+    LoadPlan parse_(const QByteArray& json);
+    QByteArray compile_() const;
     void connectElement_(Element* element);
-    void insertInsertButton_(int position);
+    int gapAt_(int y) const;
+    int gapPosition_(int gap) const;
+    int shownIndexAt_(int y) const;
+    void resetMinimap_();
+    void jumpTo_(Element* element);
+    void reflowVisible_();
+    void updateInsertButton_(int y);
     void populate_(const LoadPlan& plan);
-    int insertElement_(int position, const LoadPlan::Item item = {});
+    void rebuildSearchIndex_(const LoadPlan& plan);
+    void flushSearchIndex_();
+    void goToSearchHit_(int index);
+    QStringList speeches_() const;
+    QList<LoadPlan::Item> items_() const;
+    int insertElement_(int position, LoadPlan::Item item = {});
+    QList<Element*> insertElements_(int position, QList<LoadPlan::Item> items);
+    void removeElement_(Element* element);
+    void splitAtMarkers_(Element* element, const QList<int>& markers);
 
 private slots:
+    void scrollToTarget_();
+    void teardownSlice_();
+    void reflowSlice_();
     void onElementRoleChangeRequested_(const QString& from, const QString& to);
     void onElementRoleAddRequested_(const QString& role);
     void onQAppFocusChanged_(QWidget* old, QWidget* now);
     void onElementDeleteRequested_(Element* element);
     void onSpeechEditMouseChorded_(int key, Qt::KeyboardModifiers modifiers);
+    void onSearchQueryChanged_(const QString& query);
+    void previewReplace_();
+    void replaceAll_();
+    void undoReplace_();
+    void applyFilter_();
+    void onElementSpeechChanged_(Element* element);
+    void onElementRoleChanged_(Element* element);
+    void onElementEotChanged_(Element* element);
+    void updateMinimapViewport_();
 };